@@ -28,9 +28,14 @@
 *
 *******************************************************************************/
 #include <stdio.h>
+#include "ifi_default.h"
+#include "ifi_aliases.h"
 #include "serial_ports.h"
 #include "eeprom.h"
 #include "camera.h"
+#include "tracking.h"
+#include "camera_commands.h"
+#include "camera_adapt.h"
 
 // This variable, when equal to one, indicates that the
 // camera has successfully initialized and should be
@@ -39,13 +44,75 @@
 // function Restart_Camera().
 unsigned char camera_initialized = 0;
 
+// Set by Reconfigure_Camera() to have Camera_Handler() send
+// the camera only the settings that have changed.
+unsigned char camera_reconfigure = 0;
+
+// copy of the camera configuration that the camera last
+// acknowledged, and whether it can be trusted
+static Camera_Config_Data_Type Camera_Shadow_Config;
+static unsigned char camera_shadow_valid = 0;
+
 unsigned int camera_t_packets = 0;
-unsigned int camera_acks = 0;
-unsigned int camera_ncks = 0;
+unsigned int camera_m_packets = 0;
+unsigned int camera_s_packets = 0;
+
+// These are eight bits wide so that they can be updated by
+// the receive interrupt handler and read or cleared from the
+// main loop without tearing (see CAMERA_PARSE_IN_ISR).
+volatile unsigned char camera_acks = 0;
+volatile unsigned char camera_ncks = 0;
+
+// number of ACKs received before the first NCK since camera_ncks
+// was last cleared. The camera answers commands in the order they
+// were sent, so this is the position of the first rejected command
+// in a batch sent by Initialize_Camera().
+volatile unsigned char camera_first_nck = 0;
 
-// camera T packet structure
+// every ACK and NCK received, in the order they arrived, for
+// camera_commands.c. camera_response_count is incremented after
+// each entry is written.
+volatile unsigned char Camera_Response_Ring[CAMERA_RESPONSE_RING_SIZE];
+volatile unsigned char camera_response_count = 0;
+
+// camera T packet structure. This is a copy of the latest
+// T packet taken by Camera_Handler() once per slow loop.
 T_Packet_Data_Type T_Packet_Data;
 
+// Complete T packets are written to whichever of these two
+// buffers isn't the most recently published one, then
+// camera_t_packet_sequence is incremented to publish it. The
+// latest packet is always in T_Packet_Buffer[camera_t_packet_sequence & 1].
+// Use Camera_Get_Latest_Packet() to read it.
+T_Packet_Data_Type T_Packet_Buffer[2];
+volatile unsigned char camera_t_packet_sequence = 0;
+
+// The last T_PACKET_HISTORY_SIZE T packets, along with the slow
+// loop they arrived in and the pan/tilt servo commands that were
+// in effect at the time. The packet with sequence number n is kept
+// in T_Packet_History[n & T_PACKET_HISTORY_INDEX_MASK]. Use
+// Camera_Get_Packet_History() to read it.
+T_Packet_History_Type T_Packet_History[T_PACKET_HISTORY_SIZE];
+
+// Complete M (middle mass) and S (color statistics) packets are
+// published the same way as T packets. Use Camera_Get_Latest_M_Packet()
+// and Camera_Get_Latest_S_Packet() to read them.
+M_Packet_Data_Type M_Packet_Buffer[2];
+volatile unsigned char camera_m_packet_sequence = 0;
+S_Packet_Data_Type S_Packet_Buffer[2];
+volatile unsigned char camera_s_packet_sequence = 0;
+
+// incremented once per slow loop by Camera_Handler()
+volatile unsigned char camera_loop_count = 0;
+
+static void Camera_Publish_T_Packet(T_Packet_Data_Type *);
+static unsigned char Camera_Setting_Changed(unsigned char);
+
+// current state of the camera serial data parser. This lives
+// outside of Camera_State_Machine() so that Camera_Handler()
+// can tell when it's safe to take the T packet fast path.
+static unsigned char camera_parser_state = UNSYNCHRONIZED;
+
 // camera configuration data structure
 Camera_Config_Data_Type Camera_Config_Data;
 
@@ -66,22 +133,34 @@ Camera_Config_Data_Type Camera_Config_Data;
 *
 *	RETURNS:		nothing
 *
-*	COMMENTS:
+*	COMMENTS:		Received data is parsed by Camera_Drain(), below, which
+*					is also called from the fast loop so that most of the
+*					data has already been parsed by the time this runs.
+*
+*					The most recently published T packet is
+*					then copied into T_Packet_Data. Then the camera
+*					settings are adapted to the lighting (camera_adapt.c)
+*					and the command queue in camera_commands.c is
+*					serviced.
 *
 *******************************************************************************/
 void Camera_Handler(void)
 {
+	static unsigned char last_sequence = 0;
+	static unsigned char last_m_sequence = 0;
+	static unsigned char last_s_sequence = 0;
+	unsigned char sequence;
 	unsigned char return_value;
-	unsigned char byte_count;
-	unsigned char byte;
-	unsigned char i;
+
+	// timestamp for the packet history
+	camera_loop_count++;
 
 	// if needed, (re)initialize the camera and if the 
 	// initialization process throws an error, retry 
 	// until it's successfully initializes
 	if(camera_initialized == 0)
 	{
-		return_value = Initialize_Camera();
+		return_value = Initialize_Camera(0);
 
 		// is the camera done initializing and if so,
 		// did it initialize without an error?
@@ -97,6 +176,90 @@ void Camera_Handler(void)
 			DEBUG(("\r\nCamera: Initialized abnormally with code %u\r\n", (unsigned int)return_value));
 		}
 	}
+	// if the configuration has changed, send the camera
+	// only the settings that are different once the command
+	// queue has nothing waiting for an answer
+	else if(camera_reconfigure == 1 && Camera_Commands_In_Flight() == 0)
+	{
+		return_value = Initialize_Camera(1);
+
+		if(return_value == 1)
+		{
+			camera_reconfigure = 0;
+			DEBUG(("\r\nCamera: Reconfigured normally\r\n"));
+		}
+		// if the camera didn't take the new settings, we no longer
+		// know how it's configured, so start over from scratch
+		else if(return_value > 1)
+		{
+			camera_reconfigure = 0;
+			camera_initialized = 0;
+			DEBUG(("\r\nCamera: Reconfigured abnormally with code %u\r\n", (unsigned int)return_value));
+		}
+	}
+
+	// parse whatever the fast loop hasn't gotten to yet
+	Camera_Drain();
+
+	// take a copy of the latest T packet for this slow loop
+	Camera_Get_Latest_Packet(&T_Packet_Data, &sequence);
+
+	// account for every packet received, not just the ones we saw
+	camera_t_packets += (unsigned char)(sequence - last_sequence);
+	last_sequence = sequence;
+
+	sequence = camera_m_packet_sequence;
+	camera_m_packets += (unsigned char)(sequence - last_m_sequence);
+	last_m_sequence = sequence;
+
+	sequence = camera_s_packet_sequence;
+	camera_s_packets += (unsigned char)(sequence - last_s_sequence);
+	last_s_sequence = sequence;
+
+	#ifdef ENABLE_CAMERA_ADAPTATION
+	// adjust exposure and color thresholds to the lighting
+	Camera_Adapt();
+	#endif
+
+	// match ACKs/NCKs with queued commands and send more
+	Camera_Command_Handler();
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Drain()
+*
+*	PURPOSE:		Parses the data waiting in the camera serial port's
+*					received data queue.
+*
+*	CALLED FROM:	Camera_Handler(), above,
+*					user_routines_fast.c/Process_Data_From_Local_IO()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Received data is parsed in place in the serial port's
+*					circular queue and released in one operation after
+*					the snapshot taken by Camera_Serial_Port_Byte_Count()
+*					has been consumed. Complete T packets are decoded
+*					directly from the queue.
+*
+*					Calling this from the fast loop keeps the queue close
+*					to empty, so it can't overrun between slow loops, and
+*					publishes each T packet as soon as it arrives.
+*
+*					If CAMERA_PARSE_IN_ISR is #define'd in camera.h, the
+*					data has already been parsed by the receive interrupt
+*					handler and this does nothing.
+*
+*******************************************************************************/
+void Camera_Drain(void)
+{
+	#ifndef CAMERA_PARSE_IN_ISR
+	T_Packet_Data_Type *packet;
+	Camera_Queue_Index_Type byte_count;
+	Camera_Queue_Index_Type i;
 
 	// find out how much data, if any, is present in 
 	// the camera serial port's received data queue?
@@ -105,19 +268,231 @@ void Camera_Handler(void)
 	// have we received any data?
 	if(byte_count > 0)
 	{
-		// we have fresh data, so read each received byte one
-		// at a time and immediatly send it to the camera state
-		// machine, which is responsable for parsing the camera
-		// data packets
-		for(i=0; i<byte_count; i++)
+		// we have fresh data, so parse it in place without
+		// taking it out of the received data queue
+		i = 0;
+		while(i < byte_count)
 		{
-			// get the next data byte
-			byte = Read_Camera_Serial_Port();
+			// If we're between packets and a whole T packet is
+			// sitting in the queue, publish it straight from the
+			// queue. Otherwise, hand the camera state machine one
+			// byte, which takes care of ACKs, NCKs,
+			// resynchronization and packets that straddle the end
+			// of the data we have so far.
+			if(camera_parser_state == UNSYNCHRONIZED &&
+			   byte_count - i >= T_PACKET_FRAME_SIZE &&
+			   PEEK_CAMERA_SERIAL_PORT(i) == 255 &&
+			   PEEK_CAMERA_SERIAL_PORT(i + 1) == 'T')
+			{
+				packet = &T_Packet_Buffer[(camera_t_packet_sequence + 1) & 1];
+
+				packet->mx = PEEK_CAMERA_SERIAL_PORT(i + 2);
+				packet->my = PEEK_CAMERA_SERIAL_PORT(i + 3);
+				packet->x1 = PEEK_CAMERA_SERIAL_PORT(i + 4);
+				packet->y1 = PEEK_CAMERA_SERIAL_PORT(i + 5);
+				packet->x2 = PEEK_CAMERA_SERIAL_PORT(i + 6);
+				packet->y2 = PEEK_CAMERA_SERIAL_PORT(i + 7);
+				packet->pixels = PEEK_CAMERA_SERIAL_PORT(i + 8);
+				packet->confidence = PEEK_CAMERA_SERIAL_PORT(i + 9);
 
-			// send the byte to the camera state machine
-			Camera_State_Machine(byte);
+				Camera_Publish_T_Packet(packet);
+
+				i += T_PACKET_FRAME_SIZE;
+			}
+			else
+			{
+				Camera_State_Machine(PEEK_CAMERA_SERIAL_PORT(i));
+
+				i++;
+			}
 		}
+
+		// give all of the parsed data back to the serial
+		// port driver in one shot
+		Release_Camera_Serial_Port(byte_count);
 	}
+	#endif
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Get_Latest_Packet()
+*
+*	PURPOSE:		Copies the most recently received T packet.
+*
+*	CALLED FROM:	Camera_Handler(), above, tracking.c/Servo_Track()
+*
+*	PARAMETERS:		Pointer to where the packet should be copied and
+*					pointer to where its sequence number should be stored.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The sequence number is incremented each time a T packet
+*					is published, so a caller can tell whether it has seen
+*					a packet before by comparing it with the last one it
+*					was given. It wraps after 256 packets.
+*
+*					Packets are written to the buffer that isn't being
+*					read, so one packet arriving during the copy can't
+*					change what's being copied. If the sequence number
+*					moved at all, the copy is simply taken again. A T
+*					packet takes the better part of a millisecond to
+*					arrive, so the retry never happens more than once.
+*
+*					This never blocks and is safe to call from anywhere
+*					outside of the camera's receive interrupt handler.
+*
+*******************************************************************************/
+void Camera_Get_Latest_Packet(T_Packet_Data_Type *packet, unsigned char *sequence)
+{
+	unsigned char seq;
+
+	do
+	{
+		seq = camera_t_packet_sequence;
+		*packet = T_Packet_Buffer[seq & 1];
+	} while(seq != camera_t_packet_sequence);
+
+	*sequence = seq;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Get_Latest_M_Packet()
+*
+*	PURPOSE:		Copies the most recently received M packet.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Pointer to where the packet should be copied and
+*					pointer to where its sequence number should be stored.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Works like Camera_Get_Latest_Packet(), above.
+*
+*******************************************************************************/
+void Camera_Get_Latest_M_Packet(M_Packet_Data_Type *packet, unsigned char *sequence)
+{
+	unsigned char seq;
+
+	do
+	{
+		seq = camera_m_packet_sequence;
+		*packet = M_Packet_Buffer[seq & 1];
+	} while(seq != camera_m_packet_sequence);
+
+	*sequence = seq;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Get_Latest_S_Packet()
+*
+*	PURPOSE:		Copies the most recently received S packet.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Pointer to where the packet should be copied and
+*					pointer to where its sequence number should be stored.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Works like Camera_Get_Latest_Packet(), above.
+*
+*******************************************************************************/
+void Camera_Get_Latest_S_Packet(S_Packet_Data_Type *packet, unsigned char *sequence)
+{
+	unsigned char seq;
+
+	do
+	{
+		seq = camera_s_packet_sequence;
+		*packet = S_Packet_Buffer[seq & 1];
+	} while(seq != camera_s_packet_sequence);
+
+	*sequence = seq;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Publish_T_Packet()
+*
+*	PURPOSE:		Records a freshly decoded T packet in the packet
+*					history and makes it the latest packet.
+*
+*	CALLED FROM:	Camera_Handler(), above, and Camera_State_Machine(),
+*					below.
+*
+*	PARAMETERS:		Pointer to the idle half of T_Packet_Buffer[], which
+*					holds the new packet.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The history entry is written before the sequence number
+*					is incremented, so readers never see a sequence number
+*					whose history entry is incomplete.
+*
+*******************************************************************************/
+static void Camera_Publish_T_Packet(T_Packet_Data_Type *packet)
+{
+	T_Packet_History_Type *entry;
+
+	entry = &T_Packet_History[(unsigned char)(camera_t_packet_sequence + 1) & T_PACKET_HISTORY_INDEX_MASK];
+
+	entry->packet = *packet;
+	entry->loop = camera_loop_count;
+	entry->pan_pwm = PAN_SERVO;
+	entry->tilt_pwm = TILT_SERVO;
+
+	camera_t_packet_sequence++;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Get_Packet_History()
+*
+*	PURPOSE:		Copies an entry from the T packet history.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Age of the packet wanted, where zero is the latest
+*					packet, one the packet before it and so on, and a
+*					pointer to where the entry should be copied.
+*
+*	RETURNS:		1 if the entry was copied, 0 if the age is beyond the
+*					history kept or the entry was overwritten while it
+*					was being copied.
+*
+*	COMMENTS:		The age in slow loops of a packet is camera_loop_count
+*					minus the entry's loop member (as an unsigned char).
+*					Comparing the pan/tilt commands in the entry with the
+*					current ones tells how far the servos have moved since
+*					the image was taken.
+*
+*******************************************************************************/
+unsigned char Camera_Get_Packet_History(unsigned char age, T_Packet_History_Type *entry)
+{
+	unsigned char seq;
+
+	if(age >= T_PACKET_HISTORY_SIZE - 1)
+	{
+		return(0);
+	}
+
+	seq = camera_t_packet_sequence - age;
+
+	*entry = T_Packet_History[seq & T_PACKET_HISTORY_INDEX_MASK];
+
+	// the slot being copied is reused when packet seq + T_PACKET_HISTORY_SIZE
+	// is written, which starts once packet seq + T_PACKET_HISTORY_SIZE - 1
+	// has been published
+	if((unsigned char)(camera_t_packet_sequence - seq) >= T_PACKET_HISTORY_SIZE - 1)
+	{
+		return(0);
+	}
+
+	return(1);
 }
 
 /*******************************************************************************
@@ -130,7 +505,8 @@ void Camera_Handler(void)
 *					in the case of packets, the global data structure is
 *					updated with the new data.					
 *
-*	CALLED FROM:	Camera_Handler(), above
+*	CALLED FROM:	Camera_Handler(), above, or serial_ports.c/Rx_x_Int_Handler()
+*					if CAMERA_PARSE_IN_ISR is #define'd in camera.h
 *
 *	PARAMETERS:		unsigned char of camera serial data
 *
@@ -139,31 +515,39 @@ void Camera_Handler(void)
 *	COMMENTS:		Camera must be configured to output binary data, 
 *					not ASCII. See Raw_Mode() function.
 *
+*					Complete T packets are published to T_Packet_Buffer[]
+*					and can be read with Camera_Get_Latest_Packet().
+*					M and S packets are published to M_Packet_Buffer[]
+*					and S_Packet_Buffer[] the same way. Other packet types
+*					are ignored.
+*
 *******************************************************************************/
 void Camera_State_Machine(unsigned char byte)
 {
-	static unsigned char state = UNSYNCHRONIZED;
 	static unsigned char packet_buffer[34];
 	static unsigned char packet_buffer_index;
 	static unsigned char packet_char_count; 
+	T_Packet_Data_Type *packet;
+	M_Packet_Data_Type *m_packet;
+	S_Packet_Data_Type *s_packet;
 
-	switch(state)
+	switch(camera_parser_state)
 	{
 		case UNSYNCHRONIZED:
 
 			if(byte == 255) // start of a new data packet?
 			{
-				state = DETERMINING_PACKET_TYPE;
+				camera_parser_state = DETERMINING_PACKET_TYPE;
 			}
 			else if(byte == 'A') // start of an ACK?
 			{
 				packet_char_count = 2;
-				state = RECEIVING_ACK;
+				camera_parser_state = RECEIVING_ACK;
 			}
 			else if(byte == 'N') // start of a NCK?
 			{
 				packet_char_count = 2;
-				state = RECEIVING_NCK;
+				camera_parser_state = RECEIVING_NCK;
 			}
 			break;
 
@@ -172,11 +556,21 @@ void Camera_State_Machine(unsigned char byte)
 			if(byte == 'T') // are we receiving a "t packet"?
 			{
 				packet_buffer_index = 0;
-				state = RECEIVING_T_PACKET;
+				camera_parser_state = RECEIVING_T_PACKET;
+			}
+			else if(byte == 'M') // are we receiving a "m packet"?
+			{
+				packet_buffer_index = 0;
+				camera_parser_state = RECEIVING_M_PACKET;
+			}
+			else if(byte == 'S') // are we receiving a "s packet"?
+			{
+				packet_buffer_index = 0;
+				camera_parser_state = RECEIVING_S_PACKET;
 			}
 			else // unknown packet type; go back to the unsynchronized state
 			{
-				state = UNSYNCHRONIZED;
+				camera_parser_state = UNSYNCHRONIZED;
 			}
 			break;
 
@@ -191,18 +585,71 @@ void Camera_State_Machine(unsigned char byte)
 			
 			if(packet_buffer_index == sizeof(T_Packet_Data_Type)) // complete packet?
 			{
-				T_Packet_Data.mx = packet_buffer[0];
-				T_Packet_Data.my = packet_buffer[1];
-				T_Packet_Data.x1 = packet_buffer[2];
-				T_Packet_Data.y1 = packet_buffer[3];
-				T_Packet_Data.x2 = packet_buffer[4];
-				T_Packet_Data.y2 = packet_buffer[5];
-				T_Packet_Data.pixels = packet_buffer[6];
-				T_Packet_Data.confidence = packet_buffer[7];
-
-				camera_t_packets++;
-
-				state = UNSYNCHRONIZED; // we're done; go back to the unsynchronized state
+				// fill the buffer the reader isn't using
+				packet = &T_Packet_Buffer[(camera_t_packet_sequence + 1) & 1];
+
+				packet->mx = packet_buffer[0];
+				packet->my = packet_buffer[1];
+				packet->x1 = packet_buffer[2];
+				packet->y1 = packet_buffer[3];
+				packet->x2 = packet_buffer[4];
+				packet->y2 = packet_buffer[5];
+				packet->pixels = packet_buffer[6];
+				packet->confidence = packet_buffer[7];
+
+				Camera_Publish_T_Packet(packet);
+
+				camera_parser_state = UNSYNCHRONIZED; // we're done; go back to the unsynchronized state
+			}
+			break;
+
+		case RECEIVING_M_PACKET:
+
+			// move packet character to our buffer
+			packet_buffer[packet_buffer_index] = byte;
+			packet_buffer_index++;
+
+			if(packet_buffer_index == sizeof(M_Packet_Data_Type)) // complete packet?
+			{
+				// fill the buffer the reader isn't using
+				m_packet = &M_Packet_Buffer[(camera_m_packet_sequence + 1) & 1];
+
+				m_packet->mx = packet_buffer[0];
+				m_packet->my = packet_buffer[1];
+				m_packet->x1 = packet_buffer[2];
+				m_packet->y1 = packet_buffer[3];
+				m_packet->x2 = packet_buffer[4];
+				m_packet->y2 = packet_buffer[5];
+				m_packet->pixels = packet_buffer[6];
+				m_packet->confidence = packet_buffer[7];
+
+				camera_m_packet_sequence++;
+
+				camera_parser_state = UNSYNCHRONIZED; // we're done; go back to the unsynchronized state
+			}
+			break;
+
+		case RECEIVING_S_PACKET:
+
+			// move packet character to our buffer
+			packet_buffer[packet_buffer_index] = byte;
+			packet_buffer_index++;
+
+			if(packet_buffer_index == sizeof(S_Packet_Data_Type)) // complete packet?
+			{
+				// fill the buffer the reader isn't using
+				s_packet = &S_Packet_Buffer[(camera_s_packet_sequence + 1) & 1];
+
+				s_packet->r_mean = packet_buffer[0];
+				s_packet->g_mean = packet_buffer[1];
+				s_packet->b_mean = packet_buffer[2];
+				s_packet->r_deviation = packet_buffer[3];
+				s_packet->g_deviation = packet_buffer[4];
+				s_packet->b_deviation = packet_buffer[5];
+
+				camera_s_packet_sequence++;
+
+				camera_parser_state = UNSYNCHRONIZED; // we're done; go back to the unsynchronized state
 			}
 			break;
 
@@ -219,11 +666,13 @@ void Camera_State_Machine(unsigned char byte)
 			else if(packet_char_count == 4 && byte == '\r') // fourth character a return?
 			{
 				camera_acks++;
-				state = UNSYNCHRONIZED;
+				Camera_Response_Ring[camera_response_count & CAMERA_RESPONSE_RING_INDEX_MASK] = CAMERA_RESPONSE_ACK;
+				camera_response_count++;
+				camera_parser_state = UNSYNCHRONIZED;
 			}
 			else
 			{
-				state = UNSYNCHRONIZED;
+				camera_parser_state = UNSYNCHRONIZED;
 			}
 			break;
 
@@ -239,12 +688,18 @@ void Camera_State_Machine(unsigned char byte)
 			}
 			else if(packet_char_count == 4 && byte == '\r') // fourth character a return?
 			{
+				if(camera_ncks == 0)
+				{
+					camera_first_nck = camera_acks;
+				}
 				camera_ncks++;
-				state = UNSYNCHRONIZED;
+				Camera_Response_Ring[camera_response_count & CAMERA_RESPONSE_RING_INDEX_MASK] = CAMERA_RESPONSE_NCK;
+				camera_response_count++;
+				camera_parser_state = UNSYNCHRONIZED;
 			}
 			else
 			{
-				state = UNSYNCHRONIZED;
+				camera_parser_state = UNSYNCHRONIZED;
 			}
 			break;	
 	}
@@ -259,7 +714,9 @@ void Camera_State_Machine(unsigned char byte)
 *
 *	CALLED FROM:	Camera_Handler(), below.
 *
-*	PARAMETERS:		None.
+*	PARAMETERS:		Zero for a full initialization, or one to send the
+*					camera only the settings in Camera_Config_Data that
+*					differ from the ones it last acknowledged.
 *
 *	RETURNS:		0: Initialization in progress.
 *
@@ -283,13 +740,36 @@ void Camera_State_Machine(unsigned char byte)
 *					is called with (below) to one will force the usage of
 *					the default configuration values from camera.c.
 *
+*					The register writes, noise filter and track color
+*					commands are sent in batches of up to
+*					CAMERA_INIT_PIPELINE_DEPTH commands without waiting
+*					for each ACK. If the camera rejects a command, the
+*					rest of the initialization is done one command at a
+*					time starting with the rejected command, so a NCK is
+*					only reported if the command is rejected again.
+*
+*					A differential reconfiguration skips the idle command
+*					and the EEPROM reload done in states one and two, and
+*					skips the register and noise filter writes whose
+*					values haven't changed. The track color command is always
+*					sent because it restarts the T packet stream that the
+*					other commands interrupt. If no acknowledged copy of
+*					the configuration is available, a full initialization
+*					is done instead. Calling this function with a
+*					different parameter than the initialization in
+*					progress starts over.
+*
 *******************************************************************************/
-unsigned char Initialize_Camera(void)
+unsigned char Initialize_Camera(unsigned char reconfigure)
 {
 	static unsigned char boot_initialization_flag = 1;
 	static unsigned char initialize_flag = 1;
+	static unsigned char current_reconfigure;
+	static unsigned char differential;
 	static unsigned char state;
-	static unsigned char wait_for_ack;
+	static unsigned char batch_states[CAMERA_INIT_PIPELINE_DEPTH];
+	static unsigned char outstanding;
+	static unsigned char pipeline_depth;
 	static unsigned int loop_count;
 	static unsigned char return_value;
 	unsigned char returned_value;
@@ -307,57 +787,89 @@ unsigned char Initialize_Camera(void)
 	}
 
 	// do we need to (re)initialize the state machine?
-	if(initialize_flag == 1)
+	if(initialize_flag == 1 || reconfigure != current_reconfigure)
 	{
 		initialize_flag = 0;
-		wait_for_ack = 0;
-		state = STATE_ONE;
+		current_reconfigure = reconfigure;
+		outstanding = 0;
+		pipeline_depth = CAMERA_INIT_PIPELINE_DEPTH;
+
+		if(reconfigure == 1 && camera_shadow_valid == 1)
+		{
+			// the camera is already set up and tracking, so go
+			// straight to the commands the camera must acknowledge
+			differential = 1;
+			state = STATE_THREE;
+		}
+		else
+		{
+			// until the camera acknowledges every setting, we
+			// can't be sure what it's configured with
+			differential = 0;
+			camera_shadow_valid = 0;
+			state = STATE_ONE;
+		}
 		loop_count = 0;
 		return_value = 0;
 		camera_acks = 0;
 		camera_ncks = 0;
 	}
 
-	// do we need to wait for an ACK from the camera?
-	if(wait_for_ack == 1)
+	// are we waiting for the camera to answer a batch of commands?
+	if(outstanding > 0)
 	{
-		if(camera_acks >= 1) // got ACK?
+		if(camera_acks + camera_ncks >= outstanding) // has every command been answered?
 		{
-			// we're no longer waiting for an ACK
-			wait_for_ack = 0;
-
-			// reset the loop counter
-			loop_count = 0;
-		}
-		else if(camera_ncks >= 1) // got NCK?
-		{
-			// return with a value that signals an error happened
-			return_value = state - 1;
+			if(camera_ncks == 0)
+			{
+				// the whole batch was accepted; state already
+				// points past it
+				outstanding = 0;
+			}
+			else if(pipeline_depth > 1)
+			{
+				// The camera answers in order, so camera_first_nck tells us
+				// which command in the batch it rejected. Start again from
+				// that command, this time sending one command at a time.
+				DEBUG(("Camera: NCK in state %u; continuing one command at a time\r\n", (unsigned int)batch_states[camera_first_nck]));
+				state = batch_states[camera_first_nck];
+				pipeline_depth = 1;
+				outstanding = 0;
+			}
+			else
+			{
+				// return with a value that signals an error happened
+				return_value = batch_states[0];
+			}
 		}
 		else if(loop_count >= MAX_ACK_LOOP_COUNT) // have we waited too long?
 		{
-			// return with a value that signals an error happened
-			return_value = state + 128 - 1;
+			// return with a value that signals an error happened, using
+			// the state of the first command that wasn't answered
+			return_value = batch_states[camera_acks + camera_ncks] + 128;
 		}
 		else
 		{
-			// if we fall through to here it means that that we've sent a
-			// command to the camera, and we're still waiting to receive
-			// an ACK/NCK or time-out, so other than incrementing the loop
-			// counter, we don't do anything and continue to wait...
+			// if we fall through to here it means that that we've sent
+			// commands to the camera, and we're still waiting to receive
+			// their ACKs/NCKs or time-out, so other than incrementing the
+			// loop counter, we don't do anything and continue to wait...
 			loop_count++;
 		}
 	}
-	else
+
+	// if we're not waiting on the camera, move on to the next state
+	if(outstanding == 0 && return_value == 0)
 	{
 
 		// if debugging mode is on, send camera initialization information 
 		// to the terminal (the DEBUG() macro is defined in camera.h
 		DEBUG(("Camera: Initialization state = %u\r\n", (unsigned int)state));
 
-		// reset the ACK/NCK counters
+		// reset the ACK/NCK counters and the time-out counter
 		camera_acks = 0;
 		camera_ncks = 0;
+		loop_count = 0;
 
 		switch(state)
 		{
@@ -388,163 +900,38 @@ unsigned char Initialize_Camera(void)
 				Camera_Idle();
 				// next state
 				state = STATE_TWO;
-				// don't wait for an ACK before transitioning to the next state
-				wait_for_ack = 0;
 				break;
 
 			case STATE_TWO:
 				// next state
 				state = STATE_THREE;
-				// don't wait for an ACK before transitioning to the next state
-				wait_for_ack = 0;
-				break;
-	
-			case STATE_THREE:
-				// initialize the Common Control I register
-				Write_Camera_Module_Register(COMI_ADDRESS, Camera_Config_Data.COMI);
-				// next state
-				state = STATE_FOUR;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-	
-			case STATE_FOUR:
-				// initialize the Common Control B register
-				Write_Camera_Module_Register(COMB_ADDRESS, Camera_Config_Data.COMB);
-				// next state
-				state = STATE_FIVE;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-
-			case STATE_FIVE:
-				// initialize the Common Control J register to power-on state
-				// to disable the banding filter, which must be done before
-				// setting the Frame Rate Adjust register 2 (EHSL)
-				Write_Camera_Module_Register(COMJ_ADDRESS, Camera_Config_Data.COMJ);
-				// next state
-				state = STATE_SIX;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-		
-			case STATE_SIX:
-				// initialize the Frame Rate Adjust register 1
-				Write_Camera_Module_Register(EHSH_ADDRESS, Camera_Config_Data.EHSH);
-				// next state
-				state = STATE_SEVEN;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-		
-			case STATE_SEVEN:
-				// initialize the Frame Rate Adjust register 2
-				Write_Camera_Module_Register(EHSL_ADDRESS, Camera_Config_Data.EHSL);
-				// next state
-				state = STATE_EIGHT;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-		
-			case STATE_EIGHT:
-				// initialize the Common Control J register
-				Write_Camera_Module_Register(COMJ_ADDRESS, Camera_Config_Data.COMJ);
-				// next state
-				state = STATE_NINE;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-		
-			case STATE_NINE:
-				// initialize the Common Control A register
-				Write_Camera_Module_Register(COMA_ADDRESS, Camera_Config_Data.COMA);
-				// next state
-				state = STATE_TEN;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-		
-			case STATE_TEN:
-				// initialize the Automatic Gain Control register
-				Write_Camera_Module_Register(AGC_ADDRESS, Camera_Config_Data.AGC);
-				// next state
-				state = STATE_ELEVEN;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-		
-			case STATE_ELEVEN:
-				// initialize the Blue Gain Control register
-				Write_Camera_Module_Register(BLU_ADDRESS, Camera_Config_Data.BLU);
-				// next state
-				state = STATE_TWELVE;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-		
-			case STATE_TWELVE:
-				// initialize the Red Gain Control register
-				Write_Camera_Module_Register(RED_ADDRESS, Camera_Config_Data.RED);
-				// next state
-				state = STATE_THIRTEEN;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-		
-			case STATE_THIRTEEN:
-				// initialize the Saturation Control register
-				Write_Camera_Module_Register(SAT_ADDRESS, Camera_Config_Data.SAT);
-				// next state
-				state = STATE_FOURTEEN;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-		
-			case STATE_FOURTEEN:
-				// initialize the Brightness Control register
-				Write_Camera_Module_Register(BRT_ADDRESS, Camera_Config_Data.BRT);
-				// next state
-				state = STATE_FIFTEEN;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-		
-			case STATE_FIFTEEN:
-				// initialize the Automatic Exposure Control register
-				Write_Camera_Module_Register(AEC_ADDRESS, Camera_Config_Data.AEC);
-				// next state
-				state = STATE_SIXTEEN;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-		
-			case STATE_SIXTEEN:
-				// initialize the Noise Filter value
-				Noise_Filter(Camera_Config_Data.NF);
-				// next state
-				state = STATE_SEVENTEEN;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
 				break;
 
-			case STATE_SEVENTEEN:
-				// send the TC or Track Color command
-				Track_Color(Camera_Config_Data.R_Min, 
-							Camera_Config_Data.R_Max,
-							Camera_Config_Data.G_Min,
-							Camera_Config_Data.G_Max,
-							Camera_Config_Data.B_Min,
-							Camera_Config_Data.B_Max);
-				// next state
-				state = STATE_EIGHTEEN;
-				// wait for an ACK before transitioning to the next state
-				wait_for_ack = 1;
-				break;
-	
 			case STATE_EIGHTEEN:
+				// the camera now has everything in Camera_Config_Data
+				Camera_Shadow_Config = Camera_Config_Data;
+				camera_shadow_valid = 1;
 				// signal that we're done
 				return_value = 1;
 				break;
+
+			default:
+				// States three through seventeen each send one command,
+				// which the camera answers with an ACK or NCK. Send as
+				// many of them back to back as the pipeline allows. The
+				// camera works through them in order, so batch_states[]
+				// records which state each answer belongs to.
+				while(outstanding < pipeline_depth && state < STATE_EIGHTEEN)
+				{
+					if(differential == 0 || Camera_Setting_Changed(state) == 1)
+					{
+						Send_Camera_Initialization_Command(state);
+						batch_states[outstanding] = state;
+						outstanding++;
+					}
+					state++;
+				}
+				break;
 		}
 	}
 
@@ -560,6 +947,185 @@ unsigned char Initialize_Camera(void)
 	return(return_value);	
 }
 
+/*******************************************************************************
+*
+*	FUNCTION:		Send_Camera_Initialization_Command()
+*
+*	PURPOSE:		Sends the command that belongs to one of the states of
+*					Initialize_Camera() that the camera must acknowledge.
+*
+*	CALLED FROM:	Initialize_Camera(), above.
+*
+*	PARAMETERS:		Initialize_Camera() state (STATE_THREE to
+*					STATE_SEVENTEEN).
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The camera answers each of these commands with an ACK
+*					or NCK.
+*
+*******************************************************************************/
+void Send_Camera_Initialization_Command(unsigned char state)
+{
+	switch(state)
+	{
+		case STATE_THREE:
+			// initialize the Common Control I register
+			Write_Camera_Module_Register(COMI_ADDRESS, Camera_Config_Data.COMI);
+			break;
+
+		case STATE_FOUR:
+			// initialize the Common Control B register
+			Write_Camera_Module_Register(COMB_ADDRESS, Camera_Config_Data.COMB);
+			break;
+
+		case STATE_FIVE:
+			// initialize the Common Control J register to power-on state
+			// to disable the banding filter, which must be done before
+			// setting the Frame Rate Adjust register 2 (EHSL)
+			Write_Camera_Module_Register(COMJ_ADDRESS, Camera_Config_Data.COMJ);
+			break;
+
+		case STATE_SIX:
+			// initialize the Frame Rate Adjust register 1
+			Write_Camera_Module_Register(EHSH_ADDRESS, Camera_Config_Data.EHSH);
+			break;
+
+		case STATE_SEVEN:
+			// initialize the Frame Rate Adjust register 2
+			Write_Camera_Module_Register(EHSL_ADDRESS, Camera_Config_Data.EHSL);
+			break;
+
+		case STATE_EIGHT:
+			// initialize the Common Control J register
+			Write_Camera_Module_Register(COMJ_ADDRESS, Camera_Config_Data.COMJ);
+			break;
+
+		case STATE_NINE:
+			// initialize the Common Control A register
+			Write_Camera_Module_Register(COMA_ADDRESS, Camera_Config_Data.COMA);
+			break;
+
+		case STATE_TEN:
+			// initialize the Automatic Gain Control register
+			Write_Camera_Module_Register(AGC_ADDRESS, Camera_Config_Data.AGC);
+			break;
+
+		case STATE_ELEVEN:
+			// initialize the Blue Gain Control register
+			Write_Camera_Module_Register(BLU_ADDRESS, Camera_Config_Data.BLU);
+			break;
+
+		case STATE_TWELVE:
+			// initialize the Red Gain Control register
+			Write_Camera_Module_Register(RED_ADDRESS, Camera_Config_Data.RED);
+			break;
+
+		case STATE_THIRTEEN:
+			// initialize the Saturation Control register
+			Write_Camera_Module_Register(SAT_ADDRESS, Camera_Config_Data.SAT);
+			break;
+
+		case STATE_FOURTEEN:
+			// initialize the Brightness Control register
+			Write_Camera_Module_Register(BRT_ADDRESS, Camera_Config_Data.BRT);
+			break;
+
+		case STATE_FIFTEEN:
+			// initialize the Automatic Exposure Control register
+			Write_Camera_Module_Register(AEC_ADDRESS, Camera_Config_Data.AEC);
+			break;
+
+		case STATE_SIXTEEN:
+			// initialize the Noise Filter value
+			Noise_Filter(Camera_Config_Data.NF);
+			break;
+
+		case STATE_SEVENTEEN:
+			// send the TC or Track Color command
+			Track_Color(Camera_Config_Data.R_Min, 
+						Camera_Config_Data.R_Max,
+						Camera_Config_Data.G_Min,
+						Camera_Config_Data.G_Max,
+						Camera_Config_Data.B_Min,
+						Camera_Config_Data.B_Max);
+			break;
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Setting_Changed()
+*
+*	PURPOSE:		Determines whether the command sent in one of the
+*					states of Initialize_Camera() needs to be resent
+*					during a differential reconfiguration.
+*
+*	CALLED FROM:	Initialize_Camera(), above.
+*
+*	PARAMETERS:		Initialize_Camera() state (STATE_THREE to
+*					STATE_SEVENTEEN).
+*
+*	RETURNS:		1 if the command needs to be sent, 0 if the camera
+*					already has the value.
+*
+*	COMMENTS:		Both COMJ writes are resent when EHSL changes, because
+*					the banding filter must be disabled while EHSL is set.
+*
+*******************************************************************************/
+static unsigned char Camera_Setting_Changed(unsigned char state)
+{
+	Camera_Config_Data_Type *config = &Camera_Config_Data;
+	Camera_Config_Data_Type *shadow = &Camera_Shadow_Config;
+
+	switch(state)
+	{
+		case STATE_THREE:
+			return(config->COMI != shadow->COMI);
+
+		case STATE_FOUR:
+			return(config->COMB != shadow->COMB);
+
+		case STATE_FIVE:
+		case STATE_EIGHT:
+			return(config->COMJ != shadow->COMJ || config->EHSL != shadow->EHSL);
+
+		case STATE_SIX:
+			return(config->EHSH != shadow->EHSH);
+
+		case STATE_SEVEN:
+			return(config->EHSL != shadow->EHSL);
+
+		case STATE_NINE:
+			return(config->COMA != shadow->COMA);
+
+		case STATE_TEN:
+			return(config->AGC != shadow->AGC);
+
+		case STATE_ELEVEN:
+			return(config->BLU != shadow->BLU);
+
+		case STATE_TWELVE:
+			return(config->RED != shadow->RED);
+
+		case STATE_THIRTEEN:
+			return(config->SAT != shadow->SAT);
+
+		case STATE_FOURTEEN:
+			return(config->BRT != shadow->BRT);
+
+		case STATE_FIFTEEN:
+			return(config->AEC != shadow->AEC);
+
+		case STATE_SIXTEEN:
+			return(config->NF != shadow->NF);
+
+		default:
+			// the track color command restarts the T packet stream
+			return(1);
+	}
+}
+
 /*******************************************************************************
 *
 *	FUNCTION:		Get_Camera_Configuration()
@@ -698,15 +1264,19 @@ void Track_Color(unsigned char Rmin, unsigned char Rmax,
 				 unsigned char Gmin, unsigned char Gmax,
 				 unsigned char Bmin, unsigned char Bmax)
 {
-	Write_Camera_Serial_Port('T');
-	Write_Camera_Serial_Port('C');
-	Write_Camera_Serial_Port(6);
-	Write_Camera_Serial_Port(Rmin);
-	Write_Camera_Serial_Port(Rmax);
-	Write_Camera_Serial_Port(Gmin);
-	Write_Camera_Serial_Port(Gmax);
-	Write_Camera_Serial_Port(Bmin);
-	Write_Camera_Serial_Port(Bmax);
+	unsigned char command[9];
+
+	command[0] = 'T';
+	command[1] = 'C';
+	command[2] = 6;
+	command[3] = Rmin;
+	command[4] = Rmax;
+	command[5] = Gmin;
+	command[6] = Gmax;
+	command[7] = Bmin;
+	command[8] = Bmax;
+
+	Write_Camera_Serial_Port_Buffer(command, sizeof(command));
 }
 
 /*******************************************************************************
@@ -750,6 +1320,58 @@ void Restart_Camera(void)
 	camera_initialized = 0;
 }
 
+/*******************************************************************************
+*
+*	FUNCTION:		Reconfigure_Camera()
+*
+*	PURPOSE:		Sends the camera the settings in Camera_Config_Data
+*					that have changed since it was last configured,
+*					without going through a full reinitialization.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		none
+*
+*	RETURNS:		nothing
+*
+*	COMMENTS:		Call this after changing Camera_Config_Data, e.g.
+*					from a menu or after reloading it with
+*					Get_Camera_Configuration(). Tracking continues with
+*					the last T packet until the track color command
+*					restarts the T packet stream. If the camera isn't
+*					initialized yet, the full initialization will pick
+*					up the new settings anyway.
+*
+*******************************************************************************/
+void Reconfigure_Camera(void)
+{
+	camera_reconfigure = 1;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Invalidate_Camera_Shadow()
+*
+*	PURPOSE:		Forgets what settings the camera was last configured
+*					with.
+*
+*	CALLED FROM:	camera_adapt.c/Camera_Adapt_Send()
+*
+*	PARAMETERS:		none
+*
+*	RETURNS:		nothing
+*
+*	COMMENTS:		Call this after writing a camera register directly,
+*					so that the next Reconfigure_Camera() sends every
+*					setting in Camera_Config_Data instead of only those
+*					that changed.
+*
+*******************************************************************************/
+void Invalidate_Camera_Shadow(void)
+{
+	camera_shadow_valid = 0;
+}
+
 /*******************************************************************************
 *
 *	FUNCTION:		Get_Camera_State()
@@ -793,11 +1415,15 @@ unsigned char Get_Camera_State(void)
 *******************************************************************************/
 void Raw_Mode(unsigned char mode)
 {
-	Write_Camera_Serial_Port('R');
-	Write_Camera_Serial_Port('M');
-	Write_Camera_Serial_Port(' ');
-	Write_Camera_Serial_Port(48 + mode);
-	Write_Camera_Serial_Port('\r');
+	unsigned char command[5];
+
+	command[0] = 'R';
+	command[1] = 'M';
+	command[2] = ' ';
+	command[3] = 48 + mode;
+	command[4] = '\r';
+
+	Write_Camera_Serial_Port_Buffer(command, sizeof(command));
 }
 
 /*******************************************************************************
@@ -819,10 +1445,44 @@ void Raw_Mode(unsigned char mode)
 *******************************************************************************/
 void Noise_Filter(unsigned char threshold)
 {
-	Write_Camera_Serial_Port('N');
-	Write_Camera_Serial_Port('F');
-	Write_Camera_Serial_Port(1);
-	Write_Camera_Serial_Port(threshold);
+	unsigned char command[4];
+
+	command[0] = 'N';
+	command[1] = 'F';
+	command[2] = 1;
+	command[3] = threshold;
+
+	Write_Camera_Serial_Port_Buffer(command, sizeof(command));
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Get_Mean()
+*
+*	PURPOSE:		Properly formats and sends a GM (Get Mean) command to
+*					the camera, which makes it stream S (color statistics)
+*					packets instead of T packets.
+*
+*	CALLED FROM:	camera_commands.c/Camera_Command_Handler()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing
+*
+*	COMMENTS:		Camera must be configured to accept binary commands,
+*					not ASCII. See Raw_Mode() function. Send Track_Color()
+*					to go back to streaming T packets.
+*
+*******************************************************************************/
+void Get_Mean(void)
+{
+	unsigned char command[3];
+
+	command[0] = 'G';
+	command[1] = 'M';
+	command[2] = 0;
+
+	Write_Camera_Serial_Port_Buffer(command, sizeof(command));
 }
 
 /*******************************************************************************
@@ -844,11 +1504,15 @@ void Noise_Filter(unsigned char threshold)
 *******************************************************************************/
 void Write_Camera_Module_Register(unsigned char reg, unsigned char value)
 {
-	Write_Camera_Serial_Port('C');
-	Write_Camera_Serial_Port('R');
-	Write_Camera_Serial_Port(2);
-	Write_Camera_Serial_Port(reg);
-	Write_Camera_Serial_Port(value);
+	unsigned char command[5];
+
+	command[0] = 'C';
+	command[1] = 'R';
+	command[2] = 2;
+	command[3] = reg;
+	command[4] = value;
+
+	Write_Camera_Serial_Port_Buffer(command, sizeof(command));
 }
 
 /*******************************************************************************
@@ -868,7 +1532,7 @@ void Write_Camera_Module_Register(unsigned char reg, unsigned char value)
 *					properly set in camera.h.		
 *
 *******************************************************************************/
-unsigned char Camera_Serial_Port_Byte_Count(void)
+Camera_Queue_Index_Type Camera_Serial_Port_Byte_Count(void)
 {
 #ifdef CAMERA_SERIAL_PORT_1
 	return(Serial_Port_One_Byte_Count());
@@ -908,6 +1572,37 @@ unsigned char Read_Camera_Serial_Port(void)
 #endif
 }
 
+/*******************************************************************************
+*
+*	FUNCTION:		Release_Camera_Serial_Port()
+*
+*	PURPOSE:		Removes a block of bytes from the camera serial port's
+*					received data queue.
+*
+*	CALLED FROM:	Camera_Handler(), above.
+*
+*	PARAMETERS:		Number of bytes to remove.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The bytes are examined beforehand, in place, with the
+*					PEEK_CAMERA_SERIAL_PORT() macro. The count must not be
+*					larger than the value last returned by
+*					Camera_Serial_Port_Byte_Count().
+*
+*					This code assumes that the camera serial port has been
+*					properly set in camera.h.
+*
+*******************************************************************************/
+void Release_Camera_Serial_Port(Camera_Queue_Index_Type count)
+{
+#ifdef CAMERA_SERIAL_PORT_1
+	Release_Serial_Port_One(count);
+#else
+	Release_Serial_Port_Two(count);
+#endif
+}
+
 /*******************************************************************************
 *
 *	FUNCTION:		Write_Camera_Serial_Port()
@@ -933,6 +1628,35 @@ void Write_Camera_Serial_Port(unsigned char value)
 #endif
 }
 
+/*******************************************************************************
+*
+*	FUNCTION:		Write_Camera_Serial_Port_Buffer()
+*
+*	PURPOSE:		Sends a complete command to the camera serial port.
+*
+*	CALLED FROM:	Track_Color(), Raw_Mode(), Noise_Filter() and
+*					Write_Camera_Module_Register(), above.
+*
+*	PARAMETERS:		Pointer to the command and its length in bytes.
+*
+*	RETURNS:		Number of bytes accepted (all or nothing).
+*
+*	COMMENTS:		The command is queued in one operation, so the camera
+*					never sees half of a command.
+*
+*					This code assumes that the camera serial port has been
+*					properly set in camera.h.
+*
+*******************************************************************************/
+unsigned char Write_Camera_Serial_Port_Buffer(unsigned char *data, unsigned char count)
+{
+#ifdef CAMERA_SERIAL_PORT_1
+	return(Write_Serial_Port_One_Buffer(data, count));
+#else
+	return(Write_Serial_Port_Two_Buffer(data, count));
+#endif
+}
+
 /*******************************************************************************
 *
 *	FUNCTION:		Terminal_Serial_Port_Byte_Count()
@@ -950,7 +1674,7 @@ void Write_Camera_Serial_Port(unsigned char value)
 *					properly set in camera.h.
 *
 *******************************************************************************/
-unsigned char Terminal_Serial_Port_Byte_Count(void)
+Terminal_Queue_Index_Type Terminal_Serial_Port_Byte_Count(void)
 {
 #ifdef TERMINAL_SERIAL_PORT_1
 	return(Serial_Port_One_Byte_Count());
@@ -1014,3 +1738,30 @@ void Write_Terminal_Serial_Port(unsigned char value)
 	Write_Serial_Port_Two(value);
 #endif
 }
+
+/*******************************************************************************
+*
+*	FUNCTION:		Try_Write_Terminal_Serial_Port()
+*
+*	PURPOSE:		Sends a byte of data to the terminal serial port
+*					without ever waiting for room in the transmit queue.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Byte of data to send to the terminal serial port.
+*
+*	RETURNS:		1 if the byte was queued, 0 if the transmit queue was
+*					full.
+*
+*	COMMENTS:		This code assumes that the camera serial port has been
+*					properly set in camera.h.
+*
+*******************************************************************************/
+unsigned char Try_Write_Terminal_Serial_Port(unsigned char value)
+{
+#ifdef TERMINAL_SERIAL_PORT_1
+	return(Try_Write_Serial_Port_One(value));
+#else
+	return(Try_Write_Serial_Port_Two(value));
+#endif
+}
@@ -30,6 +30,8 @@
 #ifndef _CAMERA_H
 #define _CAMERA_H
 
+#include "serial_ports.h"
+
 // If your camera's serial port is attached to the the robot controller's
 // programming serial port, uncomment the "#define CAMERA_SERIAL_PORT_1" 
 // line. Otherwise, if your camera is attached to the TTL serial port, 
@@ -37,6 +39,14 @@
 //#define CAMERA_SERIAL_PORT_1
 #define CAMERA_SERIAL_PORT_2
 
+// Uncomment the "#define CAMERA_PARSE_IN_ISR" line to have the camera
+// serial port's receive interrupt handler feed each byte straight into
+// Camera_State_Machine() instead of storing it in the received data
+// queue for Camera_Handler() to parse once per slow loop. The queue
+// can no longer overflow and complete T packets are available from
+// Camera_Get_Latest_Packet() as soon as their last byte arrives.
+// #define CAMERA_PARSE_IN_ISR
+
 // Default camera initialization parameters that will be 
 // used if Get_Camera_Configuration() cannot find valid
 // parameters in EEPROM. Commented values in brackets are
@@ -72,6 +82,21 @@
 // timing out.
 #define MAX_ACK_LOOP_COUNT 10
 
+// Number of commands Initialize_Camera() will send to the camera
+// back to back before waiting for their ACKs. Setting this to one
+// sends one command per ACK, like the original code.
+#define CAMERA_INIT_PIPELINE_DEPTH 4
+
+// Number of ACKs/NCKs kept in Camera_Response_Ring[]. This value
+// must be a power of two (i.e., 2, 4, 8, 16) for the circular
+// queue algorithm to function correctly.
+#define CAMERA_RESPONSE_RING_SIZE 8
+#define CAMERA_RESPONSE_RING_INDEX_MASK (CAMERA_RESPONSE_RING_SIZE-1)
+
+// Camera_Response_Ring[] entries
+#define CAMERA_RESPONSE_ACK 1
+#define CAMERA_RESPONSE_NCK 2
+
 // To view debugging information on the terminal screen, uncomment the
 // "#define _DEBUG" line below.
 // #define _DEBUG
@@ -93,10 +118,34 @@
 // setup camera-related macros
 #ifdef CAMERA_SERIAL_PORT_1
 #define TERMINAL_SERIAL_PORT_2
+#define PEEK_CAMERA_SERIAL_PORT(offset) PEEK_SERIAL_PORT_ONE(offset)
+typedef Rx_1_Queue_Index_Type Camera_Queue_Index_Type;
+typedef Rx_2_Queue_Index_Type Terminal_Queue_Index_Type;
+#define TERMINAL_TX_FULL_POLICY Tx_2_Queue_Full_Policy
+#ifdef CAMERA_PARSE_IN_ISR
+#define CAMERA_STREAM_RX_1
+#endif
 #else
 #define TERMINAL_SERIAL_PORT_1
+#define PEEK_CAMERA_SERIAL_PORT(offset) PEEK_SERIAL_PORT_TWO(offset)
+typedef Rx_2_Queue_Index_Type Camera_Queue_Index_Type;
+typedef Rx_1_Queue_Index_Type Terminal_Queue_Index_Type;
+#define TERMINAL_TX_FULL_POLICY Tx_1_Queue_Full_Policy
+#ifdef CAMERA_PARSE_IN_ISR
+#define CAMERA_STREAM_RX_2
+#endif
 #endif
 
+// length of a complete T packet on the wire: the 255 and 'T'
+// header bytes followed by the eight bytes of T_Packet_Data_Type
+#define T_PACKET_FRAME_SIZE 10
+
+// Number of T packets kept in the packet history. This value must
+// be a power of two (i.e., 2, 4, 8, 16) for the circular queue
+// algorithm to function correctly.
+#define T_PACKET_HISTORY_SIZE 8
+#define T_PACKET_HISTORY_INDEX_MASK (T_PACKET_HISTORY_SIZE-1)
+
 // Get_Camera_Configuration() return values.
 #define CAMERA_EEPROM_USED 0
 #define CAMERA_EEPROM_CORRUPT 1
@@ -110,6 +159,8 @@
 #define RECEIVING_T_PACKET_BITMAP 4
 #define RECEIVING_ACK 5
 #define RECEIVING_NCK 6
+#define RECEIVING_M_PACKET 7
+#define RECEIVING_S_PACKET 8
 
 // initialize_Camera() states
 #define STATE_ONE		 1
@@ -186,28 +237,86 @@ typedef struct
 	unsigned char confidence;
 }	T_Packet_Data_Type;
 
+// camera m (middle mass) packet data structure
+typedef struct
+{
+	unsigned char mx;
+	unsigned char my;
+	unsigned char x1;
+	unsigned char y1;
+	unsigned char x2;
+	unsigned char y2;
+	unsigned char pixels;
+	unsigned char confidence;
+}	M_Packet_Data_Type;
+
+// camera s (color statistics) packet data structure
+typedef struct
+{
+	unsigned char r_mean;
+	unsigned char g_mean;
+	unsigned char b_mean;
+	unsigned char r_deviation;
+	unsigned char g_deviation;
+	unsigned char b_deviation;
+}	S_Packet_Data_Type;
+
+// camera t packet history entry
+typedef struct
+{
+	T_Packet_Data_Type packet;
+	unsigned char loop;		// camera_loop_count when the packet arrived
+	unsigned char pan_pwm;	// PAN_SERVO when the packet arrived
+	unsigned char tilt_pwm;	// TILT_SERVO when the packet arrived
+}	T_Packet_History_Type;
+
 // global variables
 extern unsigned int camera_t_packets;
+extern unsigned int camera_m_packets;
+extern unsigned int camera_s_packets;
 extern T_Packet_Data_Type T_Packet_Data;
+extern T_Packet_Data_Type T_Packet_Buffer[2];
+extern volatile unsigned char camera_t_packet_sequence;
+extern T_Packet_History_Type T_Packet_History[T_PACKET_HISTORY_SIZE];
+extern M_Packet_Data_Type M_Packet_Buffer[2];
+extern volatile unsigned char camera_m_packet_sequence;
+extern S_Packet_Data_Type S_Packet_Buffer[2];
+extern volatile unsigned char camera_s_packet_sequence;
+extern volatile unsigned char camera_loop_count;
+extern volatile unsigned char Camera_Response_Ring[CAMERA_RESPONSE_RING_SIZE];
+extern volatile unsigned char camera_response_count;
+extern unsigned char camera_reconfigure;
 extern Camera_Config_Data_Type Camera_Config_Data;
 
 // function prototypes
 void Camera_Handler(void);
+void Camera_Drain(void);
 void Camera_State_Machine(unsigned char);
-unsigned char Initialize_Camera(void);
+void Camera_Get_Latest_Packet(T_Packet_Data_Type *, unsigned char *);
+unsigned char Camera_Get_Packet_History(unsigned char, T_Packet_History_Type *);
+void Camera_Get_Latest_M_Packet(M_Packet_Data_Type *, unsigned char *);
+void Camera_Get_Latest_S_Packet(S_Packet_Data_Type *, unsigned char *);
+unsigned char Initialize_Camera(unsigned char);
+void Send_Camera_Initialization_Command(unsigned char);
 unsigned char Get_Camera_Configuration(unsigned int, unsigned char);
 void Track_Color(unsigned char, unsigned char, unsigned char, unsigned char, unsigned char, unsigned char);
 void Camera_Idle(void);
 void Restart_Camera(void);
+void Reconfigure_Camera(void);
+void Invalidate_Camera_Shadow(void);
 unsigned char Get_Camera_State(void);
 void Raw_Mode(unsigned char);
 void Noise_Filter(unsigned char);
+void Get_Mean(void);
 void Write_Camera_Module_Register(unsigned char, unsigned char);
-unsigned char Camera_Serial_Port_Byte_Count(void);
+Camera_Queue_Index_Type Camera_Serial_Port_Byte_Count(void);
 unsigned char Read_Camera_Serial_Port(void);
+void Release_Camera_Serial_Port(Camera_Queue_Index_Type);
 void Write_Camera_Serial_Port(unsigned char);
-unsigned char Terminal_Serial_Port_Byte_Count(void);
+unsigned char Write_Camera_Serial_Port_Buffer(unsigned char *, unsigned char);
+Terminal_Queue_Index_Type Terminal_Serial_Port_Byte_Count(void);
 unsigned char Read_Terminal_Serial_Port(void);
 void Write_Terminal_Serial_Port(unsigned char);
+unsigned char Try_Write_Terminal_Serial_Port(unsigned char);
 
 #endif
@@ -0,0 +1,449 @@
+/*******************************************************************************
+*
+*	TITLE:		camera_adapt.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	This file implements a slow feedback loop that adapts
+*				the camera's exposure and color thresholds to the
+*				lighting, starting from the settings in
+*				Camera_Config_Data.
+*
+*				Every slow loop, Camera_Adapt() folds the confidence
+*				and pixel count of a new T packet that has a target in
+*				it into running averages. That's all it does most of
+*				the time. Once every CAMERA_ADAPT_PERIOD slow loops it
+*				compares the average confidence with
+*				CAMERA_ADAPT_TARGET_CONFIDENCE:
+*
+*				  Confidence low, few pixels: the target is too dim or
+*				  the thresholds are too narrow. The thresholds are
+*				  widened a step; once they're as wide as allowed, the
+*				  exposure is raised a step instead.
+*
+*				  Confidence low, plenty of pixels: the thresholds are
+*				  picking up background, so they're narrowed a step.
+*
+*				  Confidence high: the exposure, then the thresholds,
+*				  are moved a step back toward Camera_Config_Data.
+*
+*				Changes are sent through the command queue in
+*				camera_commands.c as CR commands followed by a TC
+*				command, which restarts the T packet stream that the
+*				CR commands interrupt. Nothing more is changed until
+*				the TC command has been answered.
+*
+*				No adjustments are made while the camera isn't seeing
+*				a target, so the settings don't wander off while the
+*				robot is searching. Whenever the camera is initialized
+*				or reconfigured, adaptation starts over from the
+*				settings in Camera_Config_Data. Once the exposure has
+*				been adapted, a reconfiguration sends every setting,
+*				since the camera no longer holds the configured
+*				exposure.
+*
+*				Remove the adaptation by commenting out the
+*				#define ENABLE_CAMERA_ADAPTATION line in camera_adapt.h.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include "camera.h"
+#include "camera_commands.h"
+#include "camera_adapt.h"
+
+#ifdef ENABLE_CAMERA_ADAPTATION
+
+// set when adaptation must start over from Camera_Config_Data
+static unsigned char camera_adapt_reset = 1;
+
+// number of threshold steps the thresholds have been widened
+// (negative if narrowed) and exposure steps taken
+static signed char camera_adapt_widen;
+static unsigned char camera_adapt_exposure;
+
+// register values last sent to the camera
+static unsigned char camera_adapt_aec;
+static unsigned char camera_adapt_agc;
+static unsigned char camera_adapt_brt;
+
+// eight times the running average T packet confidence and pixel
+// count, over packets with a target in them
+static unsigned int camera_adapt_confidence;
+static unsigned int camera_adapt_pixels;
+
+// T packets with a target in them and slow loops so far this period
+static unsigned char camera_adapt_packets;
+static unsigned char camera_adapt_loops;
+
+// sequence number of the last T packet looked at
+static unsigned char camera_adapt_sequence;
+
+// handle of the last TC command sent, or zero
+static unsigned char camera_adapt_handle;
+
+// set if the camera may not have the settings we think it has
+static unsigned char camera_adapt_dirty;
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Adapt_Limit()
+*
+*	PURPOSE:		Limits a value to the range of an unsigned char.
+*
+*	CALLED FROM:	this file
+*
+*	PARAMETERS:		Value to limit.
+*
+*	RETURNS:		unsigned char
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+static unsigned char Camera_Adapt_Limit(int value)
+{
+	if(value < 0)
+	{
+		return(0);
+	}
+	if(value > 255)
+	{
+		return(255);
+	}
+	return((unsigned char)value);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Adapt_Register()
+*
+*	PURPOSE:		Works out the value of one of the exposure registers
+*					for the current number of exposure steps.
+*
+*	CALLED FROM:	Camera_Adapt_Send(), below.
+*
+*	PARAMETERS:		Register value from Camera_Config_Data, number of
+*					exposure steps that are taken by the registers before
+*					this one and number of steps this register takes.
+*
+*	RETURNS:		unsigned char
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+static unsigned char Camera_Adapt_Register(unsigned char base, unsigned char skip, unsigned char steps)
+{
+	unsigned char n;
+
+	if(camera_adapt_exposure <= skip)
+	{
+		return(base);
+	}
+
+	n = camera_adapt_exposure - skip;
+	if(n > steps)
+	{
+		n = steps;
+	}
+
+	return(Camera_Adapt_Limit((int)base + (int)n * CAMERA_ADAPT_EXPOSURE_STEP));
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Adapt_Thresholds()
+*
+*	PURPOSE:		Works out one pair of color thresholds for the current
+*					number of threshold steps.
+*
+*	CALLED FROM:	Camera_Adapt_Send(), below.
+*
+*	PARAMETERS:		Thresholds from Camera_Config_Data and pointers to
+*					where the adapted thresholds should be stored.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		If narrowing would cross the thresholds over, both are
+*					set to the middle of the configured range.
+*
+*******************************************************************************/
+static void Camera_Adapt_Thresholds(unsigned char min, unsigned char max, unsigned char *new_min, unsigned char *new_max)
+{
+	int offset;
+
+	offset = (int)camera_adapt_widen * CAMERA_ADAPT_THRESHOLD_STEP;
+
+	*new_min = Camera_Adapt_Limit((int)min - offset);
+	*new_max = Camera_Adapt_Limit((int)max + offset);
+
+	if(*new_min > *new_max)
+	{
+		*new_min = (unsigned char)(((unsigned int)min + (unsigned int)max) >> 1);
+		*new_max = *new_min;
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Adapt_Send()
+*
+*	PURPOSE:		Queues the commands that give the camera the current
+*					adapted settings.
+*
+*	CALLED FROM:	Camera_Adapt(), below.
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Only the exposure registers that changed are sent,
+*					but the TC command is always sent last. If the last
+*					settings may not have reached the camera, all of the
+*					exposure registers are sent again. A register's last
+*					sent value is only updated once its command has been
+*					queued.
+*
+*******************************************************************************/
+static void Camera_Adapt_Send(void)
+{
+	Camera_Command_Type command;
+	unsigned char value;
+	unsigned char resend;
+
+	// We only learn whether the TC command was answered, so if it
+	// wasn't, the CR commands queued with it may have been lost too.
+	resend = camera_adapt_dirty;
+	camera_adapt_dirty = 0;
+
+	// Once the exposure registers have been moved away from
+	// Camera_Config_Data, or we aren't sure what they hold, the
+	// next reconfiguration has to send them all to put the
+	// configured values back.
+	if(resend == 1 || camera_adapt_exposure > 0)
+	{
+		Invalidate_Camera_Shadow();
+	}
+
+	command.type = CAMERA_COMMAND_CR;
+
+	value = Camera_Adapt_Register(Camera_Config_Data.AEC, 0, CAMERA_ADAPT_AEC_STEPS);
+	if(resend == 1 || value != camera_adapt_aec)
+	{
+		command.args[0] = AEC_ADDRESS;
+		command.args[1] = value;
+		if(Camera_Command_Submit(&command, 0) == 0)
+		{
+			camera_adapt_dirty = 1;
+		}
+		else
+		{
+			camera_adapt_aec = value;
+		}
+	}
+
+	value = Camera_Adapt_Register(Camera_Config_Data.AGC, CAMERA_ADAPT_AEC_STEPS, CAMERA_ADAPT_AGC_STEPS);
+	if(resend == 1 || value != camera_adapt_agc)
+	{
+		command.args[0] = AGC_ADDRESS;
+		command.args[1] = value;
+		if(Camera_Command_Submit(&command, 0) == 0)
+		{
+			camera_adapt_dirty = 1;
+		}
+		else
+		{
+			camera_adapt_agc = value;
+		}
+	}
+
+	value = Camera_Adapt_Register(Camera_Config_Data.BRT, CAMERA_ADAPT_AEC_STEPS + CAMERA_ADAPT_AGC_STEPS, CAMERA_ADAPT_BRT_STEPS);
+	if(resend == 1 || value != camera_adapt_brt)
+	{
+		command.args[0] = BRT_ADDRESS;
+		command.args[1] = value;
+		if(Camera_Command_Submit(&command, 0) == 0)
+		{
+			camera_adapt_dirty = 1;
+		}
+		else
+		{
+			camera_adapt_brt = value;
+		}
+	}
+
+	command.type = CAMERA_COMMAND_TC;
+	Camera_Adapt_Thresholds(Camera_Config_Data.R_Min, Camera_Config_Data.R_Max, &command.args[0], &command.args[1]);
+	Camera_Adapt_Thresholds(Camera_Config_Data.G_Min, Camera_Config_Data.G_Max, &command.args[2], &command.args[3]);
+	Camera_Adapt_Thresholds(Camera_Config_Data.B_Min, Camera_Config_Data.B_Max, &command.args[4], &command.args[5]);
+
+	camera_adapt_handle = Camera_Command_Submit(&command, 0);
+	if(camera_adapt_handle == 0)
+	{
+		camera_adapt_dirty = 1;
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Adapt()
+*
+*	PURPOSE:		Adapts the camera's exposure and color thresholds to
+*					hold the T packet confidence near
+*					CAMERA_ADAPT_TARGET_CONFIDENCE.
+*
+*	CALLED FROM:	camera.c/Camera_Handler()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Must be called once per slow loop. The algorithm is
+*					described at the top of this file.
+*
+*******************************************************************************/
+void Camera_Adapt(void)
+{
+	T_Packet_Data_Type packet;
+	unsigned char sequence;
+	unsigned char status;
+	unsigned char confidence;
+	unsigned char pixels;
+	unsigned char changed;
+
+	// initializing or reconfiguring the camera puts the settings
+	// in Camera_Config_Data back, so start over when it's done
+	if(Get_Camera_State() == 0 || camera_reconfigure == 1)
+	{
+		camera_adapt_reset = 1;
+		return;
+	}
+
+	if(camera_adapt_reset == 1)
+	{
+		camera_adapt_reset = 0;
+		camera_adapt_widen = 0;
+		camera_adapt_exposure = 0;
+		camera_adapt_aec = Camera_Config_Data.AEC;
+		camera_adapt_agc = Camera_Config_Data.AGC;
+		camera_adapt_brt = Camera_Config_Data.BRT;
+		camera_adapt_confidence = CAMERA_ADAPT_TARGET_CONFIDENCE << 3;
+		camera_adapt_pixels = CAMERA_ADAPT_MIN_PIXELS << 3;
+		camera_adapt_packets = 0;
+		camera_adapt_loops = 0;
+		camera_adapt_sequence = camera_t_packet_sequence;
+		camera_adapt_handle = 0;
+		camera_adapt_dirty = 0;
+	}
+
+	// fold a new T packet with a target in it into the averages
+	if(camera_t_packet_sequence != camera_adapt_sequence)
+	{
+		Camera_Get_Latest_Packet(&packet, &sequence);
+		camera_adapt_sequence = sequence;
+
+		if(packet.pixels > 0)
+		{
+			camera_adapt_confidence = camera_adapt_confidence - (camera_adapt_confidence >> 3) + packet.confidence;
+			camera_adapt_pixels = camera_adapt_pixels - (camera_adapt_pixels >> 3) + packet.pixels;
+
+			if(camera_adapt_packets < 255)
+			{
+				camera_adapt_packets++;
+			}
+		}
+	}
+
+	// the rest is only done once per period
+	camera_adapt_loops++;
+	if(camera_adapt_loops < CAMERA_ADAPT_PERIOD)
+	{
+		return;
+	}
+	camera_adapt_loops = 0;
+
+	// don't change anything unless we've been seeing a target
+	if(camera_adapt_packets < CAMERA_ADAPT_MIN_PACKETS)
+	{
+		camera_adapt_packets = 0;
+		return;
+	}
+	camera_adapt_packets = 0;
+
+	// wait until the last adjustment has been answered
+	if(camera_adapt_handle != 0)
+	{
+		status = Camera_Command_Status(camera_adapt_handle);
+
+		if(status == CAMERA_COMMAND_QUEUED || status == CAMERA_COMMAND_SENT)
+		{
+			return;
+		}
+		if(status != CAMERA_COMMAND_ACK)
+		{
+			camera_adapt_dirty = 1;
+		}
+		camera_adapt_handle = 0;
+	}
+
+	confidence = (unsigned char)(camera_adapt_confidence >> 3);
+	pixels = (unsigned char)(camera_adapt_pixels >> 3);
+	changed = camera_adapt_dirty;
+
+	if(confidence < CAMERA_ADAPT_TARGET_CONFIDENCE - CAMERA_ADAPT_HYSTERESIS)
+	{
+		if(pixels < CAMERA_ADAPT_MIN_PIXELS)
+		{
+			// too dim or too narrow
+			if(camera_adapt_widen < CAMERA_ADAPT_MAX_WIDEN)
+			{
+				camera_adapt_widen++;
+				changed = 1;
+			}
+			else if(camera_adapt_exposure < CAMERA_ADAPT_AEC_STEPS + CAMERA_ADAPT_AGC_STEPS + CAMERA_ADAPT_BRT_STEPS)
+			{
+				camera_adapt_exposure++;
+				changed = 1;
+			}
+		}
+		else if(camera_adapt_widen > -CAMERA_ADAPT_MAX_NARROW)
+		{
+			// picking up background
+			camera_adapt_widen--;
+			changed = 1;
+		}
+	}
+	else if(confidence > CAMERA_ADAPT_TARGET_CONFIDENCE + CAMERA_ADAPT_HYSTERESIS)
+	{
+		// good lock; drift back toward the configured settings
+		if(camera_adapt_exposure > 0)
+		{
+			camera_adapt_exposure--;
+			changed = 1;
+		}
+		else if(camera_adapt_widen > 0)
+		{
+			camera_adapt_widen--;
+			changed = 1;
+		}
+		else if(camera_adapt_widen < 0)
+		{
+			camera_adapt_widen++;
+			changed = 1;
+		}
+	}
+
+	if(changed == 1)
+	{
+		Camera_Adapt_Send();
+	}
+}
+
+#endif
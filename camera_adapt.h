@@ -0,0 +1,66 @@
+/*******************************************************************************
+*
+*	TITLE:		camera_adapt.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Camera exposure and color threshold adaptation. See
+*				camera_adapt.c for details.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _CAMERA_ADAPT_H
+#define _CAMERA_ADAPT_H
+
+// comment out the next line to stop Camera_Handler() from adapting
+// the camera's exposure and color thresholds to the lighting
+#define ENABLE_CAMERA_ADAPTATION
+
+// Number of slow loops between adjustments. 38 slow loops is
+// about one second.
+#define CAMERA_ADAPT_PERIOD 38
+
+// Number of T packets with a target in them that must arrive
+// during a period before an adjustment is made.
+#define CAMERA_ADAPT_MIN_PACKETS 8
+
+// T packet confidence we're trying to hold, and how far the
+// average can stray from it before anything is changed
+#define CAMERA_ADAPT_TARGET_CONFIDENCE 50
+#define CAMERA_ADAPT_HYSTERESIS 10
+
+// If the confidence is low and the average T packet pixel count
+// is below this, the target is too dim or the thresholds too
+// narrow. Otherwise the thresholds are picking up background.
+#define CAMERA_ADAPT_MIN_PIXELS 2
+
+// Each color threshold step moves every Rmin/Gmin/Bmin down and
+// every Rmax/Gmax/Bmax up by this much (or the other way when
+// narrowing). The thresholds are never moved more than the given
+// number of steps from the ones in Camera_Config_Data.
+#define CAMERA_ADAPT_THRESHOLD_STEP 3
+#define CAMERA_ADAPT_MAX_WIDEN 8
+#define CAMERA_ADAPT_MAX_NARROW 3
+
+// Each exposure step raises AEC, then AGC once AEC has been
+// raised CAMERA_ADAPT_AEC_STEPS times, then BRT once AGC has been
+// raised CAMERA_ADAPT_AGC_STEPS times, each by this much above
+// the value in Camera_Config_Data.
+#define CAMERA_ADAPT_EXPOSURE_STEP 4
+#define CAMERA_ADAPT_AEC_STEPS 8
+#define CAMERA_ADAPT_AGC_STEPS 4
+#define CAMERA_ADAPT_BRT_STEPS 4
+
+// function prototypes
+void Camera_Adapt(void);
+
+#endif
@@ -0,0 +1,371 @@
+/*******************************************************************************
+*
+*	TITLE:		camera_commands.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	This file implements a queue for camera commands that
+*				are issued while the camera is tracking, e.g. to adjust
+*				exposure or color thresholds during a match.
+*
+*				Camera_Command_Submit() copies a command descriptor into
+*				the queue and returns a handle right away. Once per slow
+*				loop, Camera_Command_Handler() sends queued commands to
+*				the camera, keeping up to CAMERA_COMMAND_WINDOW of them
+*				waiting for an answer at once. The camera answers
+*				commands in the order they were sent, so each ACK or NCK
+*				recorded by Camera_State_Machine() completes the oldest
+*				command still waiting. A command that isn't answered
+*				within MAX_ACK_LOOP_COUNT slow loops times out, along
+*				with everything sent after it.
+*
+*				The outcome can be polled with Camera_Command_Status()
+*				or delivered to a callback that is called from
+*				Camera_Command_Handler().
+*
+*				Commands are only sent while the camera is initialized
+*				and no reconfiguration is pending, because
+*				Initialize_Camera() counts ACKs and NCKs on its own.
+*				Commands that are waiting for an answer when the camera
+*				is reinitialized are aborted. Queued commands wait.
+*
+*				Register values changed through this queue are not
+*				copied into Camera_Config_Data, so they last until the
+*				camera is next fully initialized.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include "camera.h"
+#include "camera_commands.h"
+
+// queue slot
+typedef struct
+{
+	Camera_Command_Type command;
+	Camera_Command_Callback callback;
+	unsigned char handle;	// zero if the slot has never been used
+	unsigned char status;	// CAMERA_COMMAND_xxx
+	unsigned char loops;	// slow loops spent waiting for an answer
+}	Camera_Command_Slot_Type;
+
+// Slots from camera_command_tail up to camera_command_send are
+// waiting for an answer. Slots from camera_command_send up to
+// camera_command_head are waiting to be sent. The indices run
+// freely and are masked when used.
+static Camera_Command_Slot_Type Camera_Command_Queue[CAMERA_COMMAND_QUEUE_SIZE] = {0};
+static unsigned char camera_command_tail = 0;
+static unsigned char camera_command_send = 0;
+static unsigned char camera_command_head = 0;
+
+// handle given to the next submitted command
+static unsigned char camera_command_next_handle = 1;
+
+// number of camera answers from Camera_Response_Ring[] we've used
+static unsigned char camera_command_responses = 0;
+
+// set when the next batch of answers in Camera_Response_Ring[]
+// doesn't belong to us
+static unsigned char camera_command_resync = 1;
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Command_Complete()
+*
+*	PURPOSE:		Records the final status of the oldest command in the
+*					queue, calls its callback and removes it from the
+*					queue.
+*
+*	CALLED FROM:	this file
+*
+*	PARAMETERS:		Final status (CAMERA_COMMAND_xxx).
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The slot keeps the handle and status until it's
+*					reused, so they can still be polled afterwards.
+*
+*******************************************************************************/
+static void Camera_Command_Complete(unsigned char status)
+{
+	Camera_Command_Slot_Type *slot;
+
+	slot = &Camera_Command_Queue[camera_command_tail & CAMERA_COMMAND_QUEUE_INDEX_MASK];
+
+	slot->status = status;
+	camera_command_tail++;
+
+	if(slot->callback != 0)
+	{
+		slot->callback(slot->handle, status);
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Command_Submit()
+*
+*	PURPOSE:		Queues a command to be sent to the camera.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Pointer to the command descriptor, which is copied.
+*
+*					Function to call when the command completes, or zero.
+*
+*	RETURNS:		Handle that can be passed to Camera_Command_Status(),
+*					or zero if the queue is full or the command isn't
+*					supported.
+*
+*	COMMENTS:		Raw_Mode() values that turn off ACKs and NCKs (bit 1)
+*					aren't supported, as nothing could be matched with an
+*					answer afterwards.
+*
+*******************************************************************************/
+unsigned char Camera_Command_Submit(Camera_Command_Type *command, Camera_Command_Callback callback)
+{
+	Camera_Command_Slot_Type *slot;
+	unsigned char i;
+
+	// is the queue full?
+	if((unsigned char)(camera_command_head - camera_command_tail) >= CAMERA_COMMAND_QUEUE_SIZE)
+	{
+		return(0);
+	}
+
+	if(command->type > CAMERA_COMMAND_GM ||
+	   (command->type == CAMERA_COMMAND_RM && (command->args[0] & 0x02)))
+	{
+		return(0);
+	}
+
+	slot = &Camera_Command_Queue[camera_command_head & CAMERA_COMMAND_QUEUE_INDEX_MASK];
+
+	slot->command.type = command->type;
+	for(i = 0; i < sizeof(command->args); i++)
+	{
+		slot->command.args[i] = command->args[i];
+	}
+	slot->callback = callback;
+	slot->handle = camera_command_next_handle;
+	slot->status = CAMERA_COMMAND_QUEUED;
+	slot->loops = 0;
+
+	camera_command_head++;
+
+	// zero means "no handle"
+	camera_command_next_handle++;
+	if(camera_command_next_handle == 0)
+	{
+		camera_command_next_handle = 1;
+	}
+
+	return(slot->handle);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Command_Status()
+*
+*	PURPOSE:		Returns the status of a submitted command.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Handle returned by Camera_Command_Submit().
+*
+*	RETURNS:		CAMERA_COMMAND_xxx (see camera_commands.h).
+*
+*	COMMENTS:		Once a command has completed, its status is available
+*					until CAMERA_COMMAND_QUEUE_SIZE more commands have
+*					been submitted, after which CAMERA_COMMAND_UNKNOWN is
+*					returned.
+*
+*******************************************************************************/
+unsigned char Camera_Command_Status(unsigned char handle)
+{
+	unsigned char i;
+
+	if(handle != 0)
+	{
+		for(i = 0; i < CAMERA_COMMAND_QUEUE_SIZE; i++)
+		{
+			if(Camera_Command_Queue[i].handle == handle)
+			{
+				return(Camera_Command_Queue[i].status);
+			}
+		}
+	}
+
+	return(CAMERA_COMMAND_UNKNOWN);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Commands_In_Flight()
+*
+*	PURPOSE:		Returns the number of commands that have been sent to
+*					the camera and are waiting for an answer.
+*
+*	CALLED FROM:	camera.c/Camera_Handler()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		unsigned char
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+unsigned char Camera_Commands_In_Flight(void)
+{
+	return((unsigned char)(camera_command_send - camera_command_tail));
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Command_Handler()
+*
+*	PURPOSE:		Matches camera answers with the commands waiting for
+*					them, times out commands that weren't answered and
+*					sends queued commands.
+*
+*	CALLED FROM:	camera.c/Camera_Handler()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Must be called once per slow loop, after the camera
+*					data has been parsed.
+*
+*******************************************************************************/
+void Camera_Command_Handler(void)
+{
+	Camera_Command_Slot_Type *slot;
+	unsigned char response;
+
+	// skip answers that don't belong to commands sent from here
+	if(camera_command_resync == 1)
+	{
+		camera_command_responses = camera_response_count;
+		camera_command_resync = 0;
+	}
+
+	// the camera answers in order, so each answer belongs to the
+	// oldest command that's waiting for one
+	while(camera_command_responses != camera_response_count)
+	{
+		response = Camera_Response_Ring[camera_command_responses & CAMERA_RESPONSE_RING_INDEX_MASK];
+		camera_command_responses++;
+
+		if(camera_command_tail != camera_command_send)
+		{
+			if(response == CAMERA_RESPONSE_ACK)
+			{
+				Camera_Command_Complete(CAMERA_COMMAND_ACK);
+			}
+			else
+			{
+				Camera_Command_Complete(CAMERA_COMMAND_NCK);
+			}
+		}
+	}
+
+	// if the camera is being (re)initialized, anything still waiting
+	// for an answer won't get one we can recognize
+	if(Get_Camera_State() == 0)
+	{
+		while(camera_command_tail != camera_command_send)
+		{
+			Camera_Command_Complete(CAMERA_COMMAND_ABORTED);
+		}
+		camera_command_resync = 1;
+		return;
+	}
+
+	// has the oldest command waited too long?
+	if(camera_command_tail != camera_command_send)
+	{
+		slot = &Camera_Command_Queue[camera_command_tail & CAMERA_COMMAND_QUEUE_INDEX_MASK];
+
+		if(slot->loops >= MAX_ACK_LOOP_COUNT)
+		{
+			// we've lost track of which answer goes with which
+			// command, so give up on everything that was sent
+			while(camera_command_tail != camera_command_send)
+			{
+				Camera_Command_Complete(CAMERA_COMMAND_TIMEOUT);
+			}
+			camera_command_resync = 1;
+			return;
+		}
+		slot->loops++;
+	}
+
+	// Initialize_Camera() is about to use the ACK/NCK counters
+	if(camera_reconfigure == 1)
+	{
+		return;
+	}
+
+	// send as many queued commands as the window allows
+	while(camera_command_send != camera_command_head &&
+	      Camera_Commands_In_Flight() < CAMERA_COMMAND_WINDOW)
+	{
+		slot = &Camera_Command_Queue[camera_command_send & CAMERA_COMMAND_QUEUE_INDEX_MASK];
+
+		switch(slot->command.type)
+		{
+			case CAMERA_COMMAND_TC:
+				Track_Color(slot->command.args[0],
+							slot->command.args[1],
+							slot->command.args[2],
+							slot->command.args[3],
+							slot->command.args[4],
+							slot->command.args[5]);
+				break;
+
+			case CAMERA_COMMAND_CR:
+				Write_Camera_Module_Register(slot->command.args[0], slot->command.args[1]);
+				break;
+
+			case CAMERA_COMMAND_NF:
+				Noise_Filter(slot->command.args[0]);
+				break;
+
+			case CAMERA_COMMAND_RM:
+				Raw_Mode(slot->command.args[0]);
+				break;
+
+			case CAMERA_COMMAND_GM:
+				Get_Mean();
+				break;
+
+			case CAMERA_COMMAND_IDLE:
+				// The camera's answer to an idle command can't be
+				// relied on, so wait until nothing else is waiting,
+				// send it, and ignore whatever comes back before the
+				// next slow loop.
+				if(Camera_Commands_In_Flight() != 0)
+				{
+					return;
+				}
+				Camera_Idle();
+				camera_command_send++;
+				Camera_Command_Complete(CAMERA_COMMAND_DONE);
+				camera_command_resync = 1;
+				return;
+		}
+
+		slot->status = CAMERA_COMMAND_SENT;
+		slot->loops = 0;
+		camera_command_send++;
+	}
+}
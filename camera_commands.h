@@ -0,0 +1,73 @@
+/*******************************************************************************
+*
+*	TITLE:		camera_commands.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Asynchronous camera command queue. See camera_commands.c
+*				for details.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _CAMERA_COMMANDS_H
+#define _CAMERA_COMMANDS_H
+
+// Number of commands that can be queued or waiting for an answer
+// at once. This value must be a power of two (i.e., 2, 4, 8, 16)
+// for the circular queue algorithm to function correctly.
+#define CAMERA_COMMAND_QUEUE_SIZE 8
+#define CAMERA_COMMAND_QUEUE_INDEX_MASK (CAMERA_COMMAND_QUEUE_SIZE-1)
+
+// Number of commands that will be sent to the camera before
+// waiting for the first one to be answered. This value must not
+// be larger than CAMERA_RESPONSE_RING_SIZE (see camera.h).
+#define CAMERA_COMMAND_WINDOW 4
+
+// command types
+#define CAMERA_COMMAND_TC	0	// Track_Color(): args[0..5] are Rmin..Bmax
+#define CAMERA_COMMAND_CR	1	// Write_Camera_Module_Register(): args[0] is the
+								// address, args[1] is the value
+#define CAMERA_COMMAND_NF	2	// Noise_Filter(): args[0] is the value
+#define CAMERA_COMMAND_RM	3	// Raw_Mode(): args[0] is the value
+#define CAMERA_COMMAND_IDLE	4	// Camera_Idle()
+#define CAMERA_COMMAND_GM	5	// Get_Mean()
+
+// command status returned by Camera_Command_Status() and passed
+// to completion callbacks
+#define CAMERA_COMMAND_UNKNOWN	0	// handle not found (or recycled)
+#define CAMERA_COMMAND_QUEUED	1	// waiting to be sent
+#define CAMERA_COMMAND_SENT		2	// sent, waiting for an ACK/NCK
+#define CAMERA_COMMAND_ACK		3	// camera accepted the command
+#define CAMERA_COMMAND_NCK		4	// camera rejected the command
+#define CAMERA_COMMAND_TIMEOUT	5	// no answer within MAX_ACK_LOOP_COUNT
+#define CAMERA_COMMAND_ABORTED	6	// camera was reinitialized first
+#define CAMERA_COMMAND_DONE		7	// sent; the camera doesn't answer
+									// this kind of command
+
+// camera command descriptor
+typedef struct
+{
+	unsigned char type;		// CAMERA_COMMAND_TC, CAMERA_COMMAND_CR, etc.
+	unsigned char args[6];	// command arguments (see above)
+}	Camera_Command_Type;
+
+// completion callback, called with the command's handle and
+// final status from Camera_Command_Handler()
+typedef void (*Camera_Command_Callback)(unsigned char, unsigned char);
+
+// function prototypes
+unsigned char Camera_Command_Submit(Camera_Command_Type *, Camera_Command_Callback);
+unsigned char Camera_Command_Status(unsigned char);
+unsigned char Camera_Commands_In_Flight(void);
+void Camera_Command_Handler(void);
+
+#endif
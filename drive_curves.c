@@ -0,0 +1,557 @@
+/*******************************************************************************
+*
+*	TITLE:		drive_curves.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	This file implements a small library of joystick response
+*				curves for Default_Routine(). Each driver has a curve and
+*				its parameters for each joystick axis:
+*
+*				  DRIVE_CURVE_LINEAR         output = input
+*				  DRIVE_CURVE_CUBIC          the original cubic curve
+*				  DRIVE_CURVE_EXPONENTIAL    exponential curve, like the
+*				                             old pow() code
+*				  DRIVE_CURVE_DEADBAND_EXPO  deadband around center, then
+*				                             a linear/cubic blend
+*
+*				The curves for the selected driver are computed into a
+*				256 byte table per axis by Build_Drive_Curves() whenever
+*				they change, so the drive code does one table lookup per
+*				axis no matter how complicated the curve is. The cubic
+*				curve reaches 257, which doesn't fit in a byte, so it's
+*				read from user_routines.c/Joystick_Cubic_Table[] in ROM
+*				instead and stays bit-identical to the original code.
+*
+*				The settings are kept in Drive_Curve_Config_Data, which
+*				is loaded from EEPROM by Initialize_Drive_Curves() and
+*				written back with Save_Drive_Curve_Configuration(),
+*				the same way the camera and tracking configurations are.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include "ifi_default.h"
+#include "eeprom.h"
+#include "camera.h"
+#include "drive_curves.h"
+
+// drive curve configuration data structure
+Drive_Curve_Config_Data_Type Drive_Curve_Config_Data;
+
+// Response curve tables for the selected driver. Each one fills
+// a whole RAM bank, so each gets its own section (see 18f8722.lkr).
+#pragma udata DRIVE_CURVE_X_TABLE
+static unsigned char Drive_Curve_X_Table[256];
+#pragma udata DRIVE_CURVE_Y_TABLE
+static unsigned char Drive_Curve_Y_Table[256];
+#pragma udata
+
+/*******************************************************************************
+*
+*	FUNCTION:		Initialize_Drive_Curves()
+*
+*	PURPOSE:		Loads the drive curve configuration and builds the
+*					tables for the selected driver.
+*
+*	CALLED FROM:	user_routines.c/User_Initialization()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Setting the second value that
+*					Get_Drive_Curve_Configuration() is called with (below)
+*					to one will force the usage of the default
+*					configuration values from drive_curves.h.
+*
+*******************************************************************************/
+void Initialize_Drive_Curves(void)
+{
+	unsigned char returned_value;
+
+	// load drive curve configuration structure
+	returned_value = Get_Drive_Curve_Configuration(DRIVE_CURVE_CONFIG_EEPROM_ADDRESS, 0);
+
+	// if debugging mode is on, report where the drive curve configuration
+	// data came from (DEBUG() is a macro defined in camera.h)
+	if(returned_value == DRIVE_CURVE_EEPROM_USED)
+	{
+		DEBUG(("Drive: Configuring with EEPROM data\r\n"));
+	}
+	else if (returned_value == DRIVE_CURVE_EEPROM_CORRUPT)
+	{
+		DEBUG(("Drive: EEPROM configuration corrupted; Using default parameters\r\n"));
+	}
+	else if(returned_value == DRIVE_CURVE_NO_EEPROM)
+	{
+		DEBUG(("Drive: No EEPROM configuration data found; Using default parameters\r\n"));
+	}
+	else if(returned_value == DRIVE_CURVE_FORCE_DEFAULT)
+	{
+		DEBUG(("Drive: force_default flag set; Using default parameters\r\n"));
+	}
+
+	Build_Drive_Curves();
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Get_Drive_Curve_Configuration()
+*
+*	PURPOSE:		Initializes the Drive_Curve_Config_Data structure with
+*					data stored in EEPROM. If valid data isn't present in
+*					EEPROM or the force_default flag is set, default values
+*					from drive_curves.h will be used.
+*
+*	CALLED FROM:	Initialize_Drive_Curves(), above.
+*
+*	PARAMETERS:		EEPROM address of the configuration data. Calling this
+*					function with a second value greater than zero will
+*					force it to load the configuration structure with the
+*					default values found in drive_curves.h.
+*
+*	RETURNS:		DRIVE_CURVE_EEPROM_USED if EEPROM configuration data was
+*					found and used.
+*
+*					DRIVE_CURVE_EEPROM_CORRUPT if EEPROM configuration data
+*					was corrupt and default values from drive_curves.h were
+*					used.
+*
+*					DRIVE_CURVE_NO_EEPROM if no EEPROM configuration data
+*					was found and default values from drive_curves.h were
+*					used.
+*
+*					DRIVE_CURVE_FORCE_DEFAULT if the force_default flag is
+*					set and default values from drive_curves.h were used.
+*
+*	COMMENTS:		The return values are defined in drive_curves.h. The
+*					tables aren't rebuilt; call Build_Drive_Curves() for
+*					that.
+*
+*******************************************************************************/
+unsigned char Get_Drive_Curve_Configuration(unsigned int eeprom_address, unsigned char force_default)
+{
+	unsigned char i;
+	unsigned char j;
+	unsigned char byte;
+	unsigned int checksum;
+	unsigned char return_value;
+
+	if(force_default == 0)
+	{
+		checksum = 0;
+
+		// blindly load the Drive_Curve_Config_Data structure with EEPROM
+		// data starting at "eeprom_address"
+		for(i = 0; i < sizeof(Drive_Curve_Config_Data); i++)
+		{
+			// read the EEPROM
+			byte = EEPROM_Read(eeprom_address + (unsigned int)i);
+
+			// this ugly code allows the configuration data structure
+			// to be addressed as an unsigned char array
+			((unsigned char *)(&Drive_Curve_Config_Data))[i] = byte;
+
+			// add every byte, except the last, to the checksum
+			if(i < sizeof(Drive_Curve_Config_Data) - 1)
+			{
+				checksum += (unsigned int)byte;
+			}
+		}
+
+		// make sure the identification bytes are present
+		if(Drive_Curve_Config_Data.Letter_D == 'D' && Drive_Curve_Config_Data.Letter_C == 'C')
+		{
+			// yep, they're present, so let's make sure the data isn't corrupted
+			if(Drive_Curve_Config_Data.Checksum == (unsigned char)checksum &&
+			   Drive_Curve_Config_Data.Driver < DRIVE_CURVE_DRIVER_COUNT)
+			{
+				// data is good; we're done
+				return_value = DRIVE_CURVE_EEPROM_USED;
+			}
+			else
+			{
+				// data is corrupt; use default values from drive_curves.h
+				return_value = DRIVE_CURVE_EEPROM_CORRUPT;
+			}
+		}
+		else
+		{
+			// no configuration structure found in EEPROM; use default
+			// values from drive_curves.h
+			return_value = DRIVE_CURVE_NO_EEPROM;
+		}
+	}
+	else
+	{
+		// force the use of drive_curves.h default values
+		return_value = DRIVE_CURVE_FORCE_DEFAULT;
+	}
+
+	// use configuration data from drive_curves.h if we couldn't
+	// get valid configuration data from EEPROM or if the
+	// force_default flag is set
+	if(return_value != DRIVE_CURVE_EEPROM_USED)
+	{
+		Drive_Curve_Config_Data.Letter_D = 'D';
+		Drive_Curve_Config_Data.Letter_C = 'C';
+		Drive_Curve_Config_Data.Driver = 0;
+
+		for(i = 0; i < DRIVE_CURVE_DRIVER_COUNT; i++)
+		{
+			for(j = 0; j < 2; j++)
+			{
+				Drive_Curve_Config_Data.Axis[i][j].Curve = DRIVE_CURVE_DEFAULT;
+				Drive_Curve_Config_Data.Axis[i][j].Deadband = DRIVE_CURVE_DEADBAND_DEFAULT;
+				Drive_Curve_Config_Data.Axis[i][j].Expo = DRIVE_CURVE_EXPO_DEFAULT;
+			}
+		}
+	}
+
+	return(return_value);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Save_Drive_Curve_Configuration()
+*
+*	PURPOSE:		Queues Drive_Curve_Config_Data to be written to EEPROM.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		EEPROM address to write the configuration data to.
+*
+*	RETURNS:		1 if the data was queued, 0 if there wasn't enough room
+*					on the EEPROM write queue (try again later).
+*
+*	COMMENTS:		The identification bytes and checksum are filled in
+*					here. The data is actually written a byte at a time by
+*					EEPROM_Write_Handler().
+*
+*******************************************************************************/
+unsigned char Save_Drive_Curve_Configuration(unsigned int eeprom_address)
+{
+	unsigned char i;
+	unsigned int checksum;
+
+	if(EEPROM_Queue_Free_Space() < sizeof(Drive_Curve_Config_Data))
+	{
+		return(0);
+	}
+
+	Drive_Curve_Config_Data.Letter_D = 'D';
+	Drive_Curve_Config_Data.Letter_C = 'C';
+
+	checksum = 0;
+	for(i = 0; i < sizeof(Drive_Curve_Config_Data) - 1; i++)
+	{
+		checksum += (unsigned int)((unsigned char *)(&Drive_Curve_Config_Data))[i];
+	}
+	Drive_Curve_Config_Data.Checksum = (unsigned char)checksum;
+
+	for(i = 0; i < sizeof(Drive_Curve_Config_Data); i++)
+	{
+		EEPROM_Write(eeprom_address + (unsigned int)i, ((unsigned char *)(&Drive_Curve_Config_Data))[i]);
+	}
+
+	return(1);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Select_Drive_Curve_Driver()
+*
+*	PURPOSE:		Switches to another driver's curves.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Driver number (0 to DRIVE_CURVE_DRIVER_COUNT - 1).
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Out of range driver numbers are ignored. Use
+*					Save_Drive_Curve_Configuration() to make the choice
+*					stick across power cycles.
+*
+*******************************************************************************/
+void Select_Drive_Curve_Driver(unsigned char driver)
+{
+	if(driver < DRIVE_CURVE_DRIVER_COUNT)
+	{
+		Drive_Curve_Config_Data.Driver = driver;
+		Build_Drive_Curves();
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Set_Drive_Curve()
+*
+*	PURPOSE:		Changes one axis of one driver's curve settings.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Driver number, axis (DRIVE_CURVE_X or DRIVE_CURVE_Y),
+*					curve (DRIVE_CURVE_LINEAR, etc.), deadband and expo
+*					parameter.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Out of range arguments are ignored. The tables are
+*					rebuilt if the selected driver's settings changed.
+*
+*******************************************************************************/
+void Set_Drive_Curve(unsigned char driver, unsigned char axis, unsigned char curve, unsigned char deadband, unsigned char expo)
+{
+	Drive_Curve_Axis_Type *settings;
+
+	if(driver >= DRIVE_CURVE_DRIVER_COUNT || axis > DRIVE_CURVE_Y || curve > DRIVE_CURVE_DEADBAND_EXPO)
+	{
+		return;
+	}
+
+	settings = &Drive_Curve_Config_Data.Axis[driver][axis];
+	settings->Curve = curve;
+	settings->Deadband = deadband;
+	settings->Expo = expo;
+
+	if(driver == Drive_Curve_Config_Data.Driver)
+	{
+		Build_Drive_Curves();
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Drive_Curve_Limit()
+*
+*	PURPOSE:		Limits a curve output to the range of the tables.
+*
+*	CALLED FROM:	this file
+*
+*	PARAMETERS:		Value to limit.
+*
+*	RETURNS:		unsigned char
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+static unsigned char Drive_Curve_Limit(long value)
+{
+	if(value < 0)
+	{
+		return(0);
+	}
+	if(value > 255)
+	{
+		return(255);
+	}
+	return((unsigned char)value);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Build_Drive_Curve_Table()
+*
+*	PURPOSE:		Computes one axis' response curve table.
+*
+*	CALLED FROM:	Build_Drive_Curves(), below.
+*
+*	PARAMETERS:		Pointer to the table and to the axis settings.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Only integer math is used. The exponential curve is
+*					built up a step at a time in 16.16 fixed point, once to
+*					find the full scale value and again to fill the table.
+*					DRIVE_CURVE_CUBIC tables aren't used, so they're left
+*					alone.
+*
+*******************************************************************************/
+static void Build_Drive_Curve_Table(unsigned char *table, Drive_Curve_Axis_Type *settings)
+{
+	unsigned int i;
+	unsigned char deadband;
+	unsigned char expo;
+	unsigned long power;
+	unsigned long full_scale;
+	long offset;
+	long magnitude;
+
+	switch(settings->Curve)
+	{
+		case DRIVE_CURVE_EXPONENTIAL:
+
+			expo = settings->Expo;
+			if(expo > DRIVE_CURVE_MAX_EXPONENTIAL_EXPO)
+			{
+				expo = DRIVE_CURVE_MAX_EXPONENTIAL_EXPO;
+			}
+
+			// a curve with a base of one is a straight line
+			if(expo == 0)
+			{
+				for(i = 0; i < 256; i++)
+				{
+					table[i] = (unsigned char)i;
+				}
+				break;
+			}
+
+			// find a^127 - 1, which maps to full scale
+			power = 65536;
+			for(i = 0; i < 127; i++)
+			{
+				power += (power * expo) >> 12;
+			}
+			full_scale = power - 65536;
+
+			// fill in the table outward from center
+			power = 65536;
+			for(i = 0; i <= 128; i++)
+			{
+				offset = (long)(((power - 65536) * 127) / full_scale);
+
+				if(i <= 127)
+				{
+					table[127 - i] = Drive_Curve_Limit(127 - offset);
+				}
+				table[127 + i] = Drive_Curve_Limit(127 + offset);
+
+				power += (power * expo) >> 12;
+			}
+			break;
+
+		case DRIVE_CURVE_DEADBAND_EXPO:
+
+			deadband = settings->Deadband;
+			if(deadband > DRIVE_CURVE_MAX_DEADBAND)
+			{
+				deadband = DRIVE_CURVE_MAX_DEADBAND;
+			}
+			expo = settings->Expo;
+
+			for(i = 0; i < 256; i++)
+			{
+				offset = (long)i - 127;
+				magnitude = offset < 0 ? -offset : offset;
+
+				// take out the deadband and stretch what's left back
+				// out to full scale
+				if(magnitude <= deadband)
+				{
+					magnitude = 0;
+				}
+				else
+				{
+					magnitude = ((magnitude - deadband) * 127) / (127 - deadband);
+				}
+
+				// blend the linear and cubic curves
+				magnitude = ((255 - (long)expo) * magnitude +
+							 (long)expo * ((magnitude * magnitude * magnitude) / 16129)) / 255;
+
+				if(offset < 0)
+				{
+					table[i] = Drive_Curve_Limit(127 - magnitude);
+				}
+				else
+				{
+					table[i] = Drive_Curve_Limit(127 + magnitude);
+				}
+			}
+			break;
+
+		case DRIVE_CURVE_CUBIC:
+			// read from Joystick_Cubic_Table[] instead
+			break;
+
+		default:
+			// linear
+			for(i = 0; i < 256; i++)
+			{
+				table[i] = (unsigned char)i;
+			}
+			break;
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Build_Drive_Curves()
+*
+*	PURPOSE:		Computes the response curve tables for the selected
+*					driver.
+*
+*	CALLED FROM:	this file
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Call this after changing Drive_Curve_Config_Data
+*					directly. This takes far longer than a table lookup,
+*					so it should only be done when the settings change.
+*
+*******************************************************************************/
+void Build_Drive_Curves(void)
+{
+	Build_Drive_Curve_Table(Drive_Curve_X_Table, &Drive_Curve_Config_Data.Axis[Drive_Curve_Config_Data.Driver][DRIVE_CURVE_X]);
+	Build_Drive_Curve_Table(Drive_Curve_Y_Table, &Drive_Curve_Config_Data.Axis[Drive_Curve_Config_Data.Driver][DRIVE_CURVE_Y]);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Drive_Curve_Type()
+*
+*	PURPOSE:		Returns the selected driver's curve for one axis.
+*
+*	CALLED FROM:	user_routines.c/Default_Routine()
+*
+*	PARAMETERS:		Axis (DRIVE_CURVE_X or DRIVE_CURVE_Y).
+*
+*	RETURNS:		DRIVE_CURVE_LINEAR, DRIVE_CURVE_CUBIC, etc.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+unsigned char Drive_Curve_Type(unsigned char axis)
+{
+	return(Drive_Curve_Config_Data.Axis[Drive_Curve_Config_Data.Driver][axis].Curve);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Drive_Curve_Lookup()
+*
+*	PURPOSE:		Passes a joystick axis value through the selected
+*					driver's curve for that axis.
+*
+*	CALLED FROM:	user_routines.c/Default_Routine()
+*
+*	PARAMETERS:		Axis (DRIVE_CURVE_X or DRIVE_CURVE_Y) and joystick
+*					value.
+*
+*	RETURNS:		unsigned char
+*
+*	COMMENTS:		Not used for DRIVE_CURVE_CUBIC (see the top of this
+*					file).
+*
+*******************************************************************************/
+unsigned char Drive_Curve_Lookup(unsigned char axis, unsigned char input)
+{
+	if(axis == DRIVE_CURVE_X)
+	{
+		return(Drive_Curve_X_Table[input]);
+	}
+	return(Drive_Curve_Y_Table[input]);
+}
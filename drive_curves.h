@@ -0,0 +1,98 @@
+/*******************************************************************************
+*
+*	TITLE:		drive_curves.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Joystick response curves for the drive. See drive_curves.c
+*				for details.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _DRIVE_CURVES_H
+#define _DRIVE_CURVES_H
+
+// Base address in EEPROM where Get_Drive_Curve_Configuration() will
+// look for valid drive curve configuration data. The camera and
+// tracking configurations are at zero and 32.
+#define DRIVE_CURVE_CONFIG_EEPROM_ADDRESS 64
+
+// number of drivers that can each have their own curves
+#define DRIVE_CURVE_DRIVER_COUNT 4
+
+// joystick axes
+#define DRIVE_CURVE_X 0
+#define DRIVE_CURVE_Y 1
+
+// response curves
+#define DRIVE_CURVE_LINEAR			0	// output = input
+#define DRIVE_CURVE_CUBIC			1	// (input - 127)^3 / 16129 + 127
+#define DRIVE_CURVE_EXPONENTIAL		2	// (a^|input - 127| - 1), scaled to
+										// full range, where a = 1 + Expo/4096
+#define DRIVE_CURVE_DEADBAND_EXPO	3	// Deadband around center, then a
+										// blend of linear and cubic, where
+										// Expo is the cubic share (0-255)
+
+// Largest Expo value used by DRIVE_CURVE_EXPONENTIAL. Larger values
+// are treated as this one.
+#define DRIVE_CURVE_MAX_EXPONENTIAL_EXPO 100
+
+// Largest Deadband value used by DRIVE_CURVE_DEADBAND_EXPO. Larger
+// values are treated as this one.
+#define DRIVE_CURVE_MAX_DEADBAND 120
+
+// default curve and parameters for every driver and axis. 45 gives
+// DRIVE_CURVE_EXPONENTIAL about the same base (1.01099) as the old
+// pow(1.010889286, x) code.
+#define DRIVE_CURVE_DEFAULT				DRIVE_CURVE_CUBIC
+#define DRIVE_CURVE_DEADBAND_DEFAULT	8
+#define DRIVE_CURVE_EXPO_DEFAULT		45
+
+// Get_Drive_Curve_Configuration() return values
+#define DRIVE_CURVE_EEPROM_USED 0
+#define DRIVE_CURVE_EEPROM_CORRUPT 1
+#define DRIVE_CURVE_NO_EEPROM 2
+#define DRIVE_CURVE_FORCE_DEFAULT 3
+
+// one axis of one driver's settings
+typedef struct
+{
+	unsigned char Curve;	// DRIVE_CURVE_LINEAR, DRIVE_CURVE_CUBIC, etc.
+	unsigned char Deadband;	// deadband for DRIVE_CURVE_DEADBAND_EXPO
+	unsigned char Expo;		// curve parameter (see above)
+}	Drive_Curve_Axis_Type;
+
+// this defines the drive curve configuration data structure
+// that is created in RAM and possibly EEPROM
+typedef struct
+{
+	unsigned char Letter_D;	// first identification byte
+	unsigned char Letter_C;	// second identification byte
+	unsigned char Driver;	// driver whose curves are in use
+	Drive_Curve_Axis_Type Axis[DRIVE_CURVE_DRIVER_COUNT][2];
+	unsigned char Checksum;	// eight-bit structure checksum
+}	Drive_Curve_Config_Data_Type;
+
+// global variables
+extern Drive_Curve_Config_Data_Type Drive_Curve_Config_Data;
+
+// function prototypes
+void Initialize_Drive_Curves(void);
+unsigned char Get_Drive_Curve_Configuration(unsigned int, unsigned char);
+unsigned char Save_Drive_Curve_Configuration(unsigned int);
+void Select_Drive_Curve_Driver(unsigned char);
+void Set_Drive_Curve(unsigned char, unsigned char, unsigned char, unsigned char, unsigned char);
+void Build_Drive_Curves(void);
+unsigned char Drive_Curve_Type(unsigned char);
+unsigned char Drive_Curve_Lookup(unsigned char, unsigned char);
+
+#endif
@@ -150,7 +150,6 @@ unsigned char EEPROM_Write(unsigned int address, unsigned char data)
 *******************************************************************************/
 void EEPROM_Write_Handler(void)
 {
-	unsigned char return_value;
     unsigned char temp_GIEH;
 	unsigned char temp_GIEL;
 
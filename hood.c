@@ -0,0 +1,348 @@
+/*******************************************************************************
+*
+*	TITLE:		hood.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	This file sets the shooter hood angle from the range
+*				estimate (see range.c), using a calibration table of
+*				(range, hood PWM) points. Between points, the hood
+*				command is interpolated linearly; outside the table,
+*				the nearest end point is used. The ranges must increase
+*				from one point to the next. Ranges are in inches and
+*				stop at 255, which is past the shot window in range.h.
+*
+*				The default table is kept in program memory. It holds
+*				the steps of the old if/else ladder, which was keyed
+*				by tilt servo commands 9 through 65, with the old shot
+*				window of tilt commands 14 through 39 stretched over
+*				RANGE_SHOT_MIN through RANGE_SHOT_MAX. Steps past 255
+*				inches are dropped. A recalibrated table can be saved
+*				to EEPROM with Save_Hood_Configuration() and is then
+*				used in place of the default at power up, the same way
+*				the camera and tracking configurations are handled.
+*				Tables saved before the hood was keyed by range have
+*				different identification bytes and are ignored.
+*
+*				Hood_Update() is called from both the slow loop and the
+*				autonomous loop.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include "ifi_default.h"
+#include "ifi_aliases.h"
+#include "eeprom.h"
+#include "camera.h"
+#include "range.h"
+#include "hood.h"
+
+// default calibration table
+rom const Hood_Point_Type Hood_Default_Table[HOOD_DEFAULT_POINTS] =
+{
+	{ 96, 30},
+	{101, 39},
+	{120, 39},
+	{125, 32},
+	{158, 32},
+	{163, 26}
+};
+
+// hood calibration data structure
+Hood_Config_Data_Type Hood_Config_Data;
+
+/*******************************************************************************
+*
+*	FUNCTION:		Initialize_Hood()
+*
+*	PURPOSE:		Loads the hood calibration table.
+*
+*	CALLED FROM:	user_routines.c/User_Initialization()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Setting the second value that Get_Hood_Configuration()
+*					is called with (below) to one will force the usage of
+*					the default table.
+*
+*******************************************************************************/
+void Initialize_Hood(void)
+{
+	unsigned char returned_value;
+
+	// load hood calibration structure
+	returned_value = Get_Hood_Configuration(HOOD_CONFIG_EEPROM_ADDRESS, 0);
+
+	// if debugging mode is on, report where the hood calibration
+	// data came from (DEBUG() is a macro defined in camera.h)
+	if(returned_value == HOOD_EEPROM_USED)
+	{
+		DEBUG(("Hood: Configuring with EEPROM data\r\n"));
+	}
+	else if (returned_value == HOOD_EEPROM_CORRUPT)
+	{
+		DEBUG(("Hood: EEPROM configuration corrupted; Using default table\r\n"));
+	}
+	else if(returned_value == HOOD_NO_EEPROM)
+	{
+		DEBUG(("Hood: No EEPROM configuration data found; Using default table\r\n"));
+	}
+	else if(returned_value == HOOD_FORCE_DEFAULT)
+	{
+		DEBUG(("Hood: force_default flag set; Using default table\r\n"));
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Get_Hood_Configuration()
+*
+*	PURPOSE:		Initializes the Hood_Config_Data structure with data
+*					stored in EEPROM. If a valid table isn't present in
+*					EEPROM or the force_default flag is set, the default
+*					table will be used.
+*
+*	CALLED FROM:	Initialize_Hood(), above.
+*
+*	PARAMETERS:		EEPROM address of the calibration data. Calling this
+*					function with a second value greater than zero will
+*					force it to load the default table.
+*
+*	RETURNS:		HOOD_EEPROM_USED if an EEPROM table was found and used.
+*
+*					HOOD_EEPROM_CORRUPT if the EEPROM table was corrupt
+*					and the default table was used.
+*
+*					HOOD_NO_EEPROM if no EEPROM table was found and the
+*					default table was used.
+*
+*					HOOD_FORCE_DEFAULT if the force_default flag is set and
+*					the default table was used.
+*
+*	COMMENTS:		The return values are defined in hood.h. A table with
+*					fewer than two points or with ranges that don't
+*					increase is treated as corrupt.
+*
+*******************************************************************************/
+unsigned char Get_Hood_Configuration(unsigned int eeprom_address, unsigned char force_default)
+{
+	unsigned char i;
+	unsigned char byte;
+	unsigned int checksum;
+	unsigned char return_value;
+
+	if(force_default == 0)
+	{
+		checksum = 0;
+
+		// blindly load the Hood_Config_Data structure with EEPROM
+		// data starting at "eeprom_address"
+		for(i = 0; i < sizeof(Hood_Config_Data); i++)
+		{
+			// read the EEPROM
+			byte = EEPROM_Read(eeprom_address + (unsigned int)i);
+
+			// this ugly code allows the calibration data structure
+			// to be addressed as an unsigned char array
+			((unsigned char *)(&Hood_Config_Data))[i] = byte;
+
+			// add every byte, except the last, to the checksum
+			if(i < sizeof(Hood_Config_Data) - 1)
+			{
+				checksum += (unsigned int)byte;
+			}
+		}
+
+		// make sure the identification bytes are present
+		if(Hood_Config_Data.Letter_H == 'H' && Hood_Config_Data.Letter_R == 'R')
+		{
+			// yep, they're present, so let's make sure the data isn't corrupted
+			return_value = HOOD_EEPROM_USED;
+
+			if(Hood_Config_Data.Checksum != (unsigned char)checksum ||
+			   Hood_Config_Data.Points < 2 ||
+			   Hood_Config_Data.Points > HOOD_TABLE_MAX_POINTS)
+			{
+				return_value = HOOD_EEPROM_CORRUPT;
+			}
+			else
+			{
+				for(i = 1; i < Hood_Config_Data.Points; i++)
+				{
+					if(Hood_Config_Data.Point[i].Range <= Hood_Config_Data.Point[i - 1].Range)
+					{
+						return_value = HOOD_EEPROM_CORRUPT;
+					}
+				}
+			}
+		}
+		else
+		{
+			// no calibration table found in EEPROM; use the default table
+			return_value = HOOD_NO_EEPROM;
+		}
+	}
+	else
+	{
+		// force the use of the default table
+		return_value = HOOD_FORCE_DEFAULT;
+	}
+
+	// use the default table if we couldn't get a valid table
+	// from EEPROM or if the force_default flag is set
+	if(return_value != HOOD_EEPROM_USED)
+	{
+		Hood_Config_Data.Letter_H = 'H';
+		Hood_Config_Data.Letter_R = 'R';
+		Hood_Config_Data.Points = HOOD_DEFAULT_POINTS;
+
+		for(i = 0; i < HOOD_DEFAULT_POINTS; i++)
+		{
+			Hood_Config_Data.Point[i].Range = Hood_Default_Table[i].Range;
+			Hood_Config_Data.Point[i].Hood_PWM = Hood_Default_Table[i].Hood_PWM;
+		}
+	}
+
+	return(return_value);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Save_Hood_Configuration()
+*
+*	PURPOSE:		Queues Hood_Config_Data to be written to EEPROM.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		EEPROM address to write the calibration data to.
+*
+*	RETURNS:		1 if the data was queued, 0 if there wasn't enough room
+*					on the EEPROM write queue (try again later).
+*
+*	COMMENTS:		The identification bytes and checksum are filled in
+*					here. The data is actually written a byte at a time by
+*					EEPROM_Write_Handler().
+*
+*******************************************************************************/
+unsigned char Save_Hood_Configuration(unsigned int eeprom_address)
+{
+	unsigned char i;
+	unsigned int checksum;
+
+	if(EEPROM_Queue_Free_Space() < sizeof(Hood_Config_Data))
+	{
+		return(0);
+	}
+
+	Hood_Config_Data.Letter_H = 'H';
+	Hood_Config_Data.Letter_R = 'R';
+
+	checksum = 0;
+	for(i = 0; i < sizeof(Hood_Config_Data) - 1; i++)
+	{
+		checksum += (unsigned int)((unsigned char *)(&Hood_Config_Data))[i];
+	}
+	Hood_Config_Data.Checksum = (unsigned char)checksum;
+
+	for(i = 0; i < sizeof(Hood_Config_Data); i++)
+	{
+		EEPROM_Write(eeprom_address + (unsigned int)i, ((unsigned char *)(&Hood_Config_Data))[i]);
+	}
+
+	return(1);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Hood_Interpolate()
+*
+*	PURPOSE:		Looks up the hood servo command for a range in the
+*					calibration table.
+*
+*	CALLED FROM:	Hood_Update(), below.
+*
+*	PARAMETERS:		Range to the target, in inches.
+*
+*	RETURNS:		Hood servo command.
+*
+*	COMMENTS:		Between two points the result is rounded toward the
+*					hood command of the lower point.
+*
+*******************************************************************************/
+unsigned char Hood_Interpolate(unsigned char range)
+{
+	Hood_Point_Type *low;
+	Hood_Point_Type *high;
+	unsigned char i;
+
+	low = &Hood_Config_Data.Point[0];
+
+	// before the first point?
+	if(range <= low->Range)
+	{
+		return(low->Hood_PWM);
+	}
+
+	// find the segment the range falls in
+	for(i = 1; i < Hood_Config_Data.Points; i++)
+	{
+		high = &Hood_Config_Data.Point[i];
+
+		if(range < high->Range)
+		{
+			return((unsigned char)((int)low->Hood_PWM +
+				((int)high->Hood_PWM - (int)low->Hood_PWM) * (int)(range - low->Range) /
+				(int)(high->Range - low->Range)));
+		}
+
+		low = high;
+	}
+
+	// at or past the last point
+	return(low->Hood_PWM);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Hood_Update()
+*
+*	PURPOSE:		Sets the hood servos for the range to the target.
+*
+*	CALLED FROM:	user_routines.c/Process_Data_From_Master_uP(),
+*					user_routines_fast.c/User_Autonomous_Code()
+*
+*	PARAMETERS:		Range to the target in inches, or RANGE_UNKNOWN.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		While there's no range estimate, the hood stays where
+*					the last one put it. Until the first one, it's set
+*					for the middle of the shot window.
+*
+*******************************************************************************/
+void Hood_Update(unsigned int range)
+{
+	static unsigned char hood_range = (RANGE_SHOT_MIN + RANGE_SHOT_MAX) / 2;
+
+	if(range != RANGE_UNKNOWN)
+	{
+		if(range > 255)
+		{
+			range = 255;
+		}
+		hood_range = (unsigned char)range;
+	}
+
+	HOOD_SERVO = Hood_Interpolate(hood_range);
+	HOOD_MIRROR_SERVO = 254 - HOOD_SERVO;
+}
@@ -0,0 +1,74 @@
+/*******************************************************************************
+*
+*	TITLE:		hood.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Hood angle calibration table. See hood.c for details.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _HOOD_H
+#define _HOOD_H
+
+// Base address in EEPROM where Get_Hood_Configuration() will look
+// for a valid hood calibration table. The drive curve configuration
+// ends before this.
+#define HOOD_CONFIG_EEPROM_ADDRESS 96
+
+// Largest number of points in the calibration table. With fourteen
+// points the whole table fits on the EEPROM write queue at once.
+#define HOOD_TABLE_MAX_POINTS 14
+
+// Number of points in the default calibration table in hood.c
+#define HOOD_DEFAULT_POINTS 6
+
+// hood servo PWM outputs. The second servo is mounted opposite the
+// first, so it's driven with the mirror image command.
+#define HOOD_SERVO pwm11
+#define HOOD_MIRROR_SERVO pwm12
+
+// Get_Hood_Configuration() return values
+#define HOOD_EEPROM_USED 0
+#define HOOD_EEPROM_CORRUPT 1
+#define HOOD_NO_EEPROM 2
+#define HOOD_FORCE_DEFAULT 3
+
+// one calibration point
+typedef struct
+{
+	unsigned char Range;	// range to the target, inches
+	unsigned char Hood_PWM;	// hood servo command for that range
+}	Hood_Point_Type;
+
+// this defines the hood calibration data structure that is
+// created in RAM and possibly EEPROM
+typedef struct
+{
+	unsigned char Letter_H;	// first identification byte
+	unsigned char Letter_R;	// second identification byte
+	unsigned char Points;	// number of points used in Point[]
+	Hood_Point_Type Point[HOOD_TABLE_MAX_POINTS];
+	unsigned char Checksum;	// eight-bit structure checksum
+}	Hood_Config_Data_Type;
+
+// global variables
+extern Hood_Config_Data_Type Hood_Config_Data;
+
+// function prototypes
+void Initialize_Hood(void);
+unsigned char Get_Hood_Configuration(unsigned int, unsigned char);
+unsigned char Save_Hood_Configuration(unsigned int);
+unsigned char Hood_Interpolate(unsigned char);
+void Hood_Update(unsigned int);
+
+#endif
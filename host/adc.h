@@ -0,0 +1,62 @@
+/*******************************************************************************
+*
+*	TITLE:		adc.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Host build stand-in for the C18 A/D converter library.
+*				Only what ifi_utilities.c/Get_Analog_Value() uses is here.
+*				The channel is carried in bits 3 through 6 of the second
+*				OpenADC() argument, as in the real library, and every other
+*				option is all ones so that and'ing them together leaves it
+*				alone. Conversions return Host_Analog_Value[] (see host.c).
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _ADC_H
+#define _ADC_H
+
+#define ADC_CH0 0x87
+#define ADC_CH1 0x8F
+#define ADC_CH2 0x97
+#define ADC_CH3 0x9F
+#define ADC_CH4 0xA7
+#define ADC_CH5 0xAF
+#define ADC_CH6 0xB7
+#define ADC_CH7 0xBF
+#define ADC_CH8 0xC7
+#define ADC_CH9 0xCF
+#define ADC_CH10 0xD7
+#define ADC_CH11 0xDF
+#define ADC_CH12 0xE7
+#define ADC_CH13 0xEF
+#define ADC_CH14 0xF7
+#define ADC_CH15 0xFF
+
+#define ADC_FOSC_RC 0xFF
+#define ADC_RIGHT_JUST 0xFF
+#define ADC_0_TAD 0xFF
+#define ADC_INT_OFF 0xFF
+#define ADC_VREFPLUS_VDD 0xFF
+#define ADC_VREFMINUS_VSS 0xFF
+#define ADC_16ANA 0xFF
+
+// the last value converted on each channel, in ADC counts
+extern unsigned int Host_Analog_Value[16];
+
+void OpenADC(unsigned char, unsigned char, unsigned char);
+void ConvertADC(void);
+char BusyADC(void);
+int ReadADC(void);
+void CloseADC(void);
+
+#endif
@@ -0,0 +1,674 @@
+/*******************************************************************************
+*
+*	TITLE:		camera_model.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	This file plays the part of the CMUcam2 on the camera
+*				serial port, and of the robot, turret and target it's
+*				looking at, for the host build (see host.c).
+*
+*				The camera understands what camera.c and camera_commands.c
+*				send it: "RM 5\r" in ASCII, then the raw mode CR, NF, TC
+*				and GM commands, each answered with "ACK\r" (or "NCK\r" if
+*				it's malformed or unknown). A lone carriage return stops
+*				whatever the camera is streaming, without an answer. After
+*				TC the camera streams T packets, and after GM S packets,
+*				at MODEL_FRAMES_PER_SECOND until the next byte arrives.
+*
+*				The T packets come from a simple closed loop model, driven
+*				by the PWM outputs in each frame sent to the master uP:
+*
+*				  pwm01 and pwm03 turn the robot, using the yaw.h drive
+*				  scale, so a counter-clockwise turn moves the target to
+*				  the right in the image.
+*
+*				  pwm09 (PAN_SERVO) is a turret speed command, 127 being
+*				  stop and larger values turning the camera to the right.
+*				  The turret has MODEL_TURRET_TRAVEL degrees of travel
+*				  each way from straight ahead.
+*
+*				  pwm10 (TILT_SERVO) sets the camera's elevation, with
+*				  larger values tilting it down, MODEL_TILT_LEVEL_PWM
+*				  being level.
+*
+*				  The target is a lit box MODEL_TARGET_HEIGHT inches above
+*				  the lens, at a range and bearing picked at random for
+*				  each match. Both wander during the match, and now and
+*				  then the target is hidden for a while, as if something
+*				  drove in front of it.
+*
+*				All of the model's randomness comes from the match seed,
+*				so a match can be played again exactly with -s.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include <math.h>
+#include <string.h>
+#include "p18cxxx.h"
+#include "ifi_default.h"
+#include "sim.h"
+#include "host.h"
+
+// camera frame rate
+#define MODEL_FRAMES_PER_SECOND 30.0
+
+// Image geometry, from the CMUcam2's 159 by 239 pixel image and its
+// 34 degree vertical field of view (392 rows focal length, see
+// range.h). Columns are twice as wide as rows are tall.
+#define MODEL_IMAGE_CENTER_X 80.0
+#define MODEL_IMAGE_CENTER_Y 120.0
+#define MODEL_IMAGE_WIDTH 159
+#define MODEL_IMAGE_HEIGHT 239
+#define MODEL_FOCAL_ROWS 392.0
+#define MODEL_FOCAL_COLUMNS 196.0
+
+// target size and height above the lens, in inches
+#define MODEL_TARGET_HEIGHT 86.0
+#define MODEL_TARGET_BOX_HEIGHT 6.0
+#define MODEL_TARGET_BOX_WIDTH 12.0
+
+// Share of the target's bounding box the camera reports as tracked
+// pixels. The camera's confidence is that share scaled to 255.
+#define MODEL_TARGET_FILL 0.6
+
+// range to the target, in inches, and how fast it can change
+#define MODEL_RANGE_MIN 120.0
+#define MODEL_RANGE_MAX 300.0
+#define MODEL_RANGE_RATE 20.0
+
+// The target's bearing, in degrees from the robot's starting heading,
+// stays within MODEL_BEARING_SPREAD either side of straight ahead and
+// wanders at up to MODEL_BEARING_RATE degrees per second.
+#define MODEL_BEARING_SPREAD 40.0
+#define MODEL_BEARING_RATE 6.0
+
+// how often, and for how long, in seconds, the target is hidden
+#define MODEL_HIDDEN_GAP_MIN 3.0
+#define MODEL_HIDDEN_GAP_MAX 12.0
+#define MODEL_HIDDEN_MIN 0.3
+#define MODEL_HIDDEN_MAX 2.0
+
+// Turret speed, in degrees per second for each PWM count away from
+// 127, its top speed and how long, in seconds, it takes to reach a
+// new speed. The turret can't go farther than MODEL_TURRET_TRAVEL
+// degrees either side of straight ahead.
+#define MODEL_TURRET_RATE 1.5
+#define MODEL_TURRET_MAX_RATE 120.0
+#define MODEL_TURRET_LAG 0.1
+#define MODEL_TURRET_TRAVEL 150.0
+
+// tilt servo, from tracking.h and range.h
+#define MODEL_TILT_LEVEL_PWM 114
+#define MODEL_TILT_DEGREES_PER_COUNT 0.83
+
+// Robot turn rate, in degrees per second for each count of the drive
+// turn command (yaw.h YAW_DRIVE_SCALE), and how long, in seconds,
+// it takes to reach a new rate.
+#define MODEL_YAW_RATE (11.0 / 16.0)
+#define MODEL_YAW_LAG 0.1
+
+// camera output queue size, must be a power of two
+#define MODEL_OUTPUT_SIZE 1024
+
+// random number generator state
+static unsigned long model_random_state;
+
+// camera protocol state
+static unsigned char model_command[16];
+static unsigned char model_command_length;
+static unsigned char model_command_needed;
+static unsigned char model_stream;
+static unsigned char model_output[MODEL_OUTPUT_SIZE];
+static unsigned int model_output_head;
+static unsigned int model_output_tail;
+
+// world state; angles in degrees, clockwise positive unless noted
+static double model_time;
+static double model_next_frame;
+static double model_robot_heading;	// counter-clockwise positive
+static double model_robot_rate;
+static double model_turret_angle;	// from straight ahead
+static double model_turret_rate;
+static double model_tilt;			// camera elevation, up positive
+static double model_target_bearing;
+static double model_target_bearing_rate;
+static double model_target_range;
+static double model_target_range_rate;
+static double model_next_wander;
+static double model_hidden_start;
+static double model_hidden_end;
+
+// results
+static unsigned long model_in_view_loops;
+static double model_pointing_error;
+static unsigned long model_turret_stop_loops;
+static double model_max_turret_angle;
+
+/*******************************************************************************
+*
+*	FUNCTION:		Model_Random()
+*
+*	PURPOSE:		Returns a pseudo-random number.
+*
+*	CALLED FROM:	this file
+*
+*	PARAMETERS:		Lowest and highest value wanted.
+*
+*	RETURNS:		A number from low up to high.
+*
+*	COMMENTS:		32-bit xorshift, seeded by Camera_Model_Initialize().
+*
+*******************************************************************************/
+static double Model_Random(double low, double high)
+{
+	model_random_state ^= (model_random_state << 13) & 0xFFFFFFFFUL;
+	model_random_state ^= model_random_state >> 17;
+	model_random_state ^= (model_random_state << 5) & 0xFFFFFFFFUL;
+
+	return(low + (high - low) * (double)model_random_state / 4294967296.0);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Model_Send()
+*
+*	PURPOSE:		Queues bytes for the camera to send.
+*
+*	CALLED FROM:	this file
+*
+*	PARAMETERS:		Bytes to send and how many.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Bytes that don't fit are lost, which would show up as
+*					camera errors.
+*
+*******************************************************************************/
+static void Model_Send(const unsigned char *data, unsigned int count)
+{
+	unsigned int i;
+
+	for(i = 0; i < count; i++)
+	{
+		if(model_output_head - model_output_tail < MODEL_OUTPUT_SIZE)
+		{
+			model_output[model_output_head & (MODEL_OUTPUT_SIZE - 1)] = data[i];
+			model_output_head++;
+		}
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Model_Execute()
+*
+*	PURPOSE:		Answers a complete command.
+*
+*	CALLED FROM:	Camera_Model_Receive(), below.
+*
+*	PARAMETERS:		1 if the command was sent in raw mode.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+static void Model_Execute(unsigned char raw)
+{
+	unsigned char args;
+	unsigned char accepted;
+
+	args = model_command[2];
+	accepted = 0;
+
+	if(model_command[0] == 'R' && model_command[1] == 'M')
+	{
+		accepted = !raw;
+	}
+	else if(raw && model_command[0] == 'C' && model_command[1] == 'R')
+	{
+		accepted = (args > 0 && (args & 1) == 0);
+	}
+	else if(raw && model_command[0] == 'N' && model_command[1] == 'F')
+	{
+		accepted = (args == 1);
+	}
+	else if(raw && model_command[0] == 'T' && model_command[1] == 'C')
+	{
+		accepted = (args == 6);
+		if(accepted)
+		{
+			model_stream = 'T';
+		}
+	}
+	else if(raw && model_command[0] == 'G' && model_command[1] == 'M')
+	{
+		accepted = (args == 0);
+		if(accepted)
+		{
+			model_stream = 'S';
+		}
+	}
+
+	if(accepted)
+	{
+		Model_Send((const unsigned char *)"ACK\r", 4);
+	}
+	else
+	{
+		Model_Send((const unsigned char *)"NCK\r", 4);
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Model_Target()
+*
+*	PURPOSE:		Works out where the target is in the camera's image.
+*
+*	CALLED FROM:	this file
+*
+*	PARAMETERS:		Pointers to the column and row of the target's center,
+*					set here.
+*
+*	RETURNS:		1 if the target is in view, 0 if not.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+static unsigned char Model_Target(double *column, double *row)
+{
+	double bearing;
+	double elevation;
+
+	bearing = model_target_bearing + model_robot_heading - model_turret_angle;
+	elevation = atan2(MODEL_TARGET_HEIGHT, model_target_range) * 180.0 / M_PI - model_tilt;
+
+	*column = MODEL_IMAGE_CENTER_X + MODEL_FOCAL_COLUMNS * tan(bearing * M_PI / 180.0);
+	*row = MODEL_IMAGE_CENTER_Y - MODEL_FOCAL_ROWS * tan(elevation * M_PI / 180.0);
+
+	if(fabs(bearing) >= 90.0 || fabs(elevation) >= 90.0 ||
+	   (model_time >= model_hidden_start && model_time < model_hidden_end))
+	{
+		return(0);
+	}
+
+	return(*column >= 1.0 && *column <= MODEL_IMAGE_WIDTH &&
+		   *row >= 1.0 && *row <= MODEL_IMAGE_HEIGHT);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Model_Clip()
+*
+*	PURPOSE:		Limits an image coordinate to the image.
+*
+*	CALLED FROM:	Model_T_Packet(), below.
+*
+*	PARAMETERS:		Coordinate and the largest allowed.
+*
+*	RETURNS:		Clipped coordinate.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+static unsigned char Model_Clip(double value, unsigned char max)
+{
+	if(value < 1.0)
+	{
+		return(1);
+	}
+	if(value > max)
+	{
+		return(max);
+	}
+	return((unsigned char)(value + 0.5));
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Model_T_Packet()
+*
+*	PURPOSE:		Sends a T packet for the current frame.
+*
+*	CALLED FROM:	Camera_Model_Step(), below.
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		A packet of zeros means the target isn't in view.
+*
+*******************************************************************************/
+static void Model_T_Packet(void)
+{
+	unsigned char packet[10];
+	double column;
+	double row;
+	double width;
+	double height;
+	double pixels;
+
+	memset(packet, 0, sizeof(packet));
+	packet[0] = 255;
+	packet[1] = 'T';
+
+	if(Model_Target(&column, &row))
+	{
+		// a pixel of noise either way
+		column += Model_Random(-1.0, 1.0);
+		row += Model_Random(-1.0, 1.0);
+
+		height = MODEL_TARGET_BOX_HEIGHT * MODEL_FOCAL_ROWS / model_target_range;
+		width = MODEL_TARGET_BOX_WIDTH * MODEL_FOCAL_COLUMNS / model_target_range;
+		pixels = width * height * MODEL_TARGET_FILL;
+
+		packet[2] = Model_Clip(column, MODEL_IMAGE_WIDTH);
+		packet[3] = Model_Clip(row, MODEL_IMAGE_HEIGHT);
+		packet[4] = Model_Clip(column - width / 2.0, MODEL_IMAGE_WIDTH);
+		packet[5] = Model_Clip(row - height / 2.0, MODEL_IMAGE_HEIGHT);
+		packet[6] = Model_Clip(column + width / 2.0, MODEL_IMAGE_WIDTH);
+		packet[7] = Model_Clip(row + height / 2.0, MODEL_IMAGE_HEIGHT);
+		packet[8] = pixels > 255.0 ? 255 : (unsigned char)pixels;
+		packet[9] = (unsigned char)(255.0 * MODEL_TARGET_FILL);
+	}
+
+	Model_Send(packet, sizeof(packet));
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Model_S_Packet()
+*
+*	PURPOSE:		Sends an S packet for the current frame.
+*
+*	CALLED FROM:	Camera_Model_Step(), below.
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The color statistics of a mostly dark field.
+*
+*******************************************************************************/
+static void Model_S_Packet(void)
+{
+	static const unsigned char packet[8] = {255, 'S', 40, 60, 30, 12, 16, 10};
+
+	Model_Send(packet, sizeof(packet));
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Model_Initialize()
+*
+*	PURPOSE:		Sets up the camera, robot and target for a new match.
+*
+*	CALLED FROM:	host.c/Host_Start_Match()
+*
+*	PARAMETERS:		Match seed.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+void Camera_Model_Initialize(unsigned int seed)
+{
+	model_random_state = ((unsigned long)seed * 2654435761UL + 1UL) & 0xFFFFFFFFUL;
+	if(model_random_state == 0)
+	{
+		model_random_state = 1;
+	}
+
+	model_command_length = 0;
+	model_command_needed = 0;
+	model_stream = 0;
+	model_output_head = 0;
+	model_output_tail = 0;
+
+	model_time = 0.0;
+	model_next_frame = 1.0 / MODEL_FRAMES_PER_SECOND;
+	model_robot_heading = 0.0;
+	model_robot_rate = 0.0;
+	model_turret_angle = 0.0;
+	model_turret_rate = 0.0;
+	model_tilt = 0.0;
+	model_target_bearing = Model_Random(-MODEL_BEARING_SPREAD, MODEL_BEARING_SPREAD);
+	model_target_bearing_rate = 0.0;
+	model_target_range = Model_Random(MODEL_RANGE_MIN, MODEL_RANGE_MAX);
+	model_target_range_rate = 0.0;
+	model_next_wander = 0.0;
+	model_hidden_start = Model_Random(MODEL_HIDDEN_GAP_MIN, MODEL_HIDDEN_GAP_MAX);
+	model_hidden_end = model_hidden_start + Model_Random(MODEL_HIDDEN_MIN, MODEL_HIDDEN_MAX);
+
+	model_in_view_loops = 0;
+	model_pointing_error = 0.0;
+	model_turret_stop_loops = 0;
+	model_max_turret_angle = 0.0;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Model_Receive()
+*
+*	PURPOSE:		Takes a byte sent to the camera.
+*
+*	CALLED FROM:	host.c/Host_Transmit()
+*
+*	PARAMETERS:		The byte.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Raw mode commands are two letters, an argument count
+*					and the arguments. ASCII commands end with a carriage
+*					return.
+*
+*******************************************************************************/
+void Camera_Model_Receive(unsigned char byte)
+{
+	// anything sent to the camera stops the stream
+	model_stream = 0;
+
+	if(model_command_length == 0 && byte == '\r')
+	{
+		return;
+	}
+
+	model_command[model_command_length] = byte;
+	model_command_length++;
+
+	if(model_command_length == 3 && byte != ' ' && byte != '\r')
+	{
+		model_command_needed = 3 + byte;
+	}
+
+	if(model_command_length >= 3 && model_command_needed == 0 && byte == '\r')
+	{
+		Model_Execute(0);
+	}
+	else if(model_command_length >= 3 && model_command_length == model_command_needed)
+	{
+		Model_Execute(1);
+	}
+	else if(model_command_length < sizeof(model_command))
+	{
+		return;
+	}
+	else
+	{
+		Model_Send((const unsigned char *)"NCK\r", 4);
+	}
+
+	model_command_length = 0;
+	model_command_needed = 0;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Model_Step()
+*
+*	PURPOSE:		Moves the robot, turret and target on by one slow loop
+*					and sends the camera frames taken in that time.
+*
+*	CALLED FROM:	host.c/Host_Advance()
+*
+*	PARAMETERS:		The frame being sent to the master uP.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+void Camera_Model_Step(tx_data_ptr ptr)
+{
+	double dt;
+	double rate;
+	double column;
+	double row;
+
+	dt = HOST_LOOP_MICROSECONDS / 1e6;
+	model_time += dt;
+
+	// robot
+	rate = ((int)ptr->rc_pwm01 + (int)ptr->rc_pwm03 - 254) * MODEL_YAW_RATE;
+	model_robot_rate += (rate - model_robot_rate) * dt / MODEL_YAW_LAG;
+	model_robot_heading += model_robot_rate * dt;
+
+	// turret
+	rate = ((int)ptr->rc_pwm09 - 127) * MODEL_TURRET_RATE;
+	if(rate > MODEL_TURRET_MAX_RATE)
+	{
+		rate = MODEL_TURRET_MAX_RATE;
+	}
+	else if(rate < -MODEL_TURRET_MAX_RATE)
+	{
+		rate = -MODEL_TURRET_MAX_RATE;
+	}
+	model_turret_rate += (rate - model_turret_rate) * dt / MODEL_TURRET_LAG;
+	model_turret_angle += model_turret_rate * dt;
+
+	if(fabs(model_turret_angle) >= MODEL_TURRET_TRAVEL)
+	{
+		model_turret_angle = model_turret_angle > 0.0 ? MODEL_TURRET_TRAVEL : -MODEL_TURRET_TRAVEL;
+		model_turret_rate = 0.0;
+		model_turret_stop_loops++;
+	}
+	if(fabs(model_turret_angle) > model_max_turret_angle)
+	{
+		model_max_turret_angle = fabs(model_turret_angle);
+	}
+
+	// tilt servo
+	model_tilt = (MODEL_TILT_LEVEL_PWM - (int)ptr->rc_pwm10) * MODEL_TILT_DEGREES_PER_COUNT;
+
+	// target wanders, changing course once a second
+	if(model_time >= model_next_wander)
+	{
+		model_next_wander += 1.0;
+		model_target_bearing_rate = Model_Random(-MODEL_BEARING_RATE, MODEL_BEARING_RATE);
+		model_target_range_rate = Model_Random(-MODEL_RANGE_RATE, MODEL_RANGE_RATE);
+	}
+	model_target_bearing += model_target_bearing_rate * dt;
+	model_target_range += model_target_range_rate * dt;
+	if(fabs(model_target_bearing) > MODEL_BEARING_SPREAD)
+	{
+		model_target_bearing_rate = -model_target_bearing_rate;
+		model_target_bearing += 2.0 * model_target_bearing_rate * dt;
+	}
+	if(model_target_range < MODEL_RANGE_MIN || model_target_range > MODEL_RANGE_MAX)
+	{
+		model_target_range_rate = -model_target_range_rate;
+		model_target_range += 2.0 * model_target_range_rate * dt;
+	}
+
+	// and is hidden now and then
+	if(model_time >= model_hidden_end)
+	{
+		model_hidden_start = model_hidden_end + Model_Random(MODEL_HIDDEN_GAP_MIN, MODEL_HIDDEN_GAP_MAX);
+		model_hidden_end = model_hidden_start + Model_Random(MODEL_HIDDEN_MIN, MODEL_HIDDEN_MAX);
+	}
+
+	// camera frames taken during this slow loop
+	while(model_next_frame <= model_time)
+	{
+		model_next_frame += 1.0 / MODEL_FRAMES_PER_SECOND;
+
+		if(model_stream == 'T')
+		{
+			Model_T_Packet();
+		}
+		else if(model_stream == 'S')
+		{
+			Model_S_Packet();
+		}
+	}
+
+	// how well the turret is pointed while the target can be seen
+	if(Model_Target(&column, &row))
+	{
+		model_in_view_loops++;
+		model_pointing_error += fabs(model_target_bearing + model_robot_heading - model_turret_angle);
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Model_Transmit()
+*
+*	PURPOSE:		Gets the next byte the camera is sending.
+*
+*	CALLED FROM:	host.c/Host_Advance()
+*
+*	PARAMETERS:		Pointer to where the byte goes.
+*
+*	RETURNS:		1 if there was a byte, 0 if not.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+unsigned char Camera_Model_Transmit(unsigned char *byte)
+{
+	if(model_output_tail == model_output_head)
+	{
+		return(0);
+	}
+
+	*byte = model_output[model_output_tail & (MODEL_OUTPUT_SIZE - 1)];
+	model_output_tail++;
+
+	return(1);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Camera_Model_Results()
+*
+*	PURPOSE:		Adds the model's view of the match to its results.
+*
+*	CALLED FROM:	host.c/Host_End_Match()
+*
+*	PARAMETERS:		Match results.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+void Camera_Model_Results(Host_Match_Result_Type *result)
+{
+	result->in_view_loops = model_in_view_loops;
+	result->pointing_error = model_pointing_error;
+	result->turret_stop_loops = model_turret_stop_loops;
+	result->max_turret_angle = model_max_turret_angle;
+}
@@ -0,0 +1,24 @@
+/*******************************************************************************
+*
+*	TITLE:		capture.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Host build stand-in for the C18 capture.h. ifi_utilities.c
+*				includes it, but the robot code doesn't use anything in it.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _CAPTURE_H
+#define _CAPTURE_H
+
+#endif
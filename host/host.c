@@ -0,0 +1,988 @@
+/*******************************************************************************
+*
+*	TITLE:		host.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	This file lets the robot code run as an ordinary Linux
+*				program, so that whole matches can be played against a
+*				model of the camera and the robot thousands of times a
+*				minute. See sim.c for how to build and run it.
+*
+*				It stands in for three things:
+*
+*				  The PIC18F8722 registers the robot code touches (see
+*				  p18f8722.h). Interrupts are taken whenever the code
+*				  turns an interrupt enable on or off, which is also when
+*				  the code expects them to happen. The serial ports are
+*				  infinitely fast: a byte loaded into TXREGx is gone at
+*				  once, and TXxIF never goes low. The number of bytes
+*				  sent per slow loop is recorded instead, so that code
+*				  that would swamp a real 115200 baud port still shows
+*				  up. The EEPROM starts out erased, like a new robot
+*				  controller. Timer3 counts host time at the rate it
+*				  would count instruction cycles on a 10 MIPS part.
+*
+*				  The parts of the IFI library the robot code calls,
+*				  including the master uP's 26.2ms SPI frame, which is
+*				  flagged in statusflag.NEW_SPI_DATA the way the SPI
+*				  interrupt would. The frame itself comes from sim.c.
+*
+*				  A CMUcam2 on the camera serial port, which comes from
+*				  camera_model.c. What the robot code sends to the
+*				  camera each slow loop is passed to the model and the
+*				  model's answers and T packets come back through the
+*				  camera port's receive interrupt before the next one.
+*
+*				Each match runs in its own process, forked from a parent
+*				that never runs any robot code, so that every match
+*				starts from power up. The child sends its results back
+*				to the parent through a pipe when the match ends.
+*
+*				C18's _H_USER stream (see stdio.h) goes through
+*				_user_putc(), so once serial_ports.c points stdout at it,
+*				printf() output goes out the same serial port it would on
+*				the robot. What reaches the terminal port is copied to the
+*				real stdout with -v.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "p18cxxx.h"
+#include "ifi_default.h"
+#include "ifi_utilities.h"
+#include "user_routines.h"
+#include "serial_ports.h"
+#include "camera.h"
+#include <usart.h>
+#include <adc.h>
+#include "sim.h"
+#include "host.h"
+
+// the port the camera is on, from camera.h, and the terminal's port
+#ifdef CAMERA_SERIAL_PORT_1
+#define HOST_CAMERA_PORT 1
+#define HOST_TERMINAL_PORT 2
+#else
+#define HOST_CAMERA_PORT 2
+#define HOST_TERMINAL_PORT 1
+#endif
+
+// Seconds a match may run before it's taken to be stuck. A match
+// normally takes a few tens of milliseconds.
+#define HOST_MATCH_TIMEOUT 60
+
+// C18's _H_USER stream
+FILE *Host_User_Stream;
+
+// last value converted on each analog input
+unsigned int Host_Analog_Value[16];
+
+// command line options
+static int host_argc;
+static char **host_argv;
+static unsigned int host_matches = HOST_DEFAULT_MATCHES;
+static unsigned int host_seed = 0;
+static unsigned char host_verbose = 0;
+
+// pipe to the parent, in a match process
+static int host_result_fd = -1;
+
+// real stdout, for the terminal port's output with -v
+static FILE *host_terminal;
+
+// set once User_Proc_Is_Ready() has been called
+static unsigned char host_user_ready = 0;
+
+// set when the master uP has a new frame for us
+static unsigned char host_frame_ready = 1;
+
+// set while InterruptHandlerLow() is running
+static unsigned char host_in_interrupt = 0;
+
+// set while Process_Data_From_Master_uP() is running
+static unsigned char host_in_slow_loop = 0;
+
+// serial port registers and statistics, indexed by port number
+static unsigned char host_txreg[3];
+static unsigned char host_tx_pending[3];
+static unsigned char host_rcreg[3];
+static unsigned long host_tx_loop_bytes[3];
+static unsigned long host_tx_max[3];
+static unsigned long host_uart_over_budget = 0;
+static unsigned long host_rx_overruns = 0;
+
+// EEPROM contents
+static unsigned char host_eeprom[1024];
+
+// Timer3 and A/D converter
+static unsigned int host_timer3 = 0;
+static unsigned char host_timer3_low;
+static unsigned char host_adc_channel = 0;
+
+static void Host_Transmit(unsigned char, unsigned char);
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_Arguments()
+*
+*	PURPOSE:		Saves the command line, which main() doesn't take.
+*
+*	CALLED FROM:	the C runtime, before main()
+*
+*	PARAMETERS:		Command line, as for main().
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		glibc passes the command line to constructors.
+*
+*******************************************************************************/
+static void __attribute__((constructor)) Host_Arguments(int argc, char **argv)
+{
+	host_argc = argc;
+	host_argv = argv;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_Clock()
+*
+*	PURPOSE:		Returns the host's monotonic clock.
+*
+*	CALLED FROM:	this file, sim.c
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Time in nanoseconds.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+unsigned long Host_Clock(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return((unsigned long)now.tv_sec * 1000000000UL + (unsigned long)now.tv_nsec);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_Poll()
+*
+*	PURPOSE:		Takes the interrupts that are pending and enabled, and
+*					flags a new frame from the master uP.
+*
+*	CALLED FROM:	the PIE1bits, PIE3bits and INTCONbits macros in
+*					p18f8722.h, this file
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Runs before the register access, so an interrupt
+*					enabled by the access is taken at the next one.
+*
+*					The next frame isn't flagged while the slow loop is
+*					still running. On the robot it is 26.2ms away, and
+*					user_routines.c calls Getdata() again after its
+*					Putdata(), which would throw it away.
+*
+*******************************************************************************/
+void Host_Poll(void)
+{
+	if(host_in_interrupt)
+	{
+		return;
+	}
+
+	if(host_frame_ready && host_user_ready && host_in_slow_loop == 0)
+	{
+		host_frame_ready = 0;
+		statusflag.NEW_SPI_DATA = 1;
+	}
+
+	if(Host_INTCON.GIEH == 0 || Host_INTCON.GIEL == 0)
+	{
+		return;
+	}
+
+	host_in_interrupt = 1;
+
+	while((Host_PIR1.RC1IF && Host_PIE1.RC1IE) ||
+		  (Host_PIR1.TX1IF && Host_PIE1.TX1IE) ||
+		  (Host_PIR3.RC2IF && Host_PIE3.RC2IE) ||
+		  (Host_PIR3.TX2IF && Host_PIE3.TX2IE))
+	{
+		InterruptHandlerLow();
+	}
+
+	host_in_interrupt = 0;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		__wrap_Process_Data_From_Master_uP()
+*
+*	PURPOSE:		Notes when the slow loop is running, for Host_Poll().
+*
+*	CALLED FROM:	main.c, in place of Process_Data_From_Master_uP(), by
+*					way of the linker's --wrap option (see the Makefile)
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+void __real_Process_Data_From_Master_uP(void);
+
+void __wrap_Process_Data_From_Master_uP(void)
+{
+	host_in_slow_loop = 1;
+	__real_Process_Data_From_Master_uP();
+	host_in_slow_loop = 0;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_Receive()
+*
+*	PURPOSE:		Delivers a byte to a serial port's receiver.
+*
+*	CALLED FROM:	Host_Advance(), below.
+*
+*	PARAMETERS:		Port number and the byte.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		A byte that arrives before the last one was read is
+*					lost and sets OERR.
+*
+*******************************************************************************/
+static void Host_Receive(unsigned char port, unsigned char byte)
+{
+	if(port == 1)
+	{
+		if(Host_PIR1.RC1IF)
+		{
+			Host_RCSTA1.OERR = 1;
+			host_rx_overruns++;
+			return;
+		}
+		Host_PIR1.RC1IF = 1;
+	}
+	else
+	{
+		if(Host_PIR3.RC2IF)
+		{
+			Host_RCSTA2.OERR = 1;
+			host_rx_overruns++;
+			return;
+		}
+		Host_PIR3.RC2IF = 1;
+	}
+
+	host_rcreg[port] = byte;
+
+	Host_Poll();
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_Flush_TX()
+*
+*	PURPOSE:		Sends the byte last loaded into a port's TXREG.
+*
+*	CALLED FROM:	this file
+*
+*	PARAMETERS:		Port number.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Host_TXREG() can only hand out the register; the
+*					byte is stored after it returns.
+*
+*******************************************************************************/
+static void Host_Flush_TX(unsigned char port)
+{
+	if(host_tx_pending[port])
+	{
+		host_tx_pending[port] = 0;
+		Host_Transmit(port, host_txreg[port]);
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_TXREG()
+*
+*	PURPOSE:		Stands in for TXREG1 and TXREG2.
+*
+*	CALLED FROM:	the TXREG1 and TXREG2 macros in p18f8722.h
+*
+*	PARAMETERS:		Port number.
+*
+*	RETURNS:		Pointer to the register.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+unsigned char *Host_TXREG(unsigned char port)
+{
+	Host_Flush_TX(port);
+	host_tx_pending[port] = 1;
+
+	return(&host_txreg[port]);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_RCREG()
+*
+*	PURPOSE:		Stands in for RCREG1 and RCREG2.
+*
+*	CALLED FROM:	the RCREG1 and RCREG2 macros in p18f8722.h
+*
+*	PARAMETERS:		Port number.
+*
+*	RETURNS:		Pointer to the register.
+*
+*	COMMENTS:		Reading the register clears the receive interrupt flag.
+*
+*******************************************************************************/
+unsigned char *Host_RCREG(unsigned char port)
+{
+	if(port == 1)
+	{
+		Host_PIR1.RC1IF = 0;
+	}
+	else
+	{
+		Host_PIR3.RC2IF = 0;
+	}
+
+	return(&host_rcreg[port]);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_Transmit()
+*
+*	PURPOSE:		Sends a byte out of a serial port.
+*
+*	CALLED FROM:	Host_Flush_TX(), above.
+*
+*	PARAMETERS:		Port number and the byte.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+static void Host_Transmit(unsigned char port, unsigned char byte)
+{
+	host_tx_loop_bytes[port]++;
+
+	if(port == HOST_CAMERA_PORT)
+	{
+		Camera_Model_Receive(byte);
+	}
+	else if(host_verbose)
+	{
+		putc(byte, host_terminal);
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_EEPROM_Clock()
+*
+*	PURPOSE:		Carries out a pending EEPROM read or write.
+*
+*	CALLED FROM:	the EECON1bits, PIR2bits and EEDATA macros in
+*					p18f8722.h
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Writes finish at once and set EEIF.
+*
+*******************************************************************************/
+void Host_EEPROM_Clock(void)
+{
+	unsigned int address;
+
+	address = (((unsigned int)Host_EEADRH << 8) | Host_EEADR) & (sizeof(host_eeprom) - 1);
+
+	if(Host_EECON1.RD)
+	{
+		Host_EEDATA = host_eeprom[address];
+		Host_EECON1.RD = 0;
+	}
+
+	if(Host_EECON1.WR)
+	{
+		if(Host_EECON1.WREN)
+		{
+			host_eeprom[address] = Host_EEDATA;
+		}
+		Host_EECON1.WR = 0;
+		Host_PIR2.EEIF = 1;
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_TMR3L()
+*
+*	PURPOSE:		Stands in for TMR3L.
+*
+*	CALLED FROM:	the TMR3L macro in p18f8722.h
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Pointer to the register.
+*
+*	COMMENTS:		Reading TMR3L latches the high byte into TMR3H.
+*					Writes to the timer are ignored.
+*
+*******************************************************************************/
+unsigned char *Host_TMR3L(void)
+{
+	unsigned long prescale;
+
+	if(Host_T3CON.TMR3ON)
+	{
+		prescale = 1UL << (Host_T3CON.T3CKPS1 * 2 + Host_T3CON.T3CKPS0);
+		host_timer3 = (unsigned int)(Host_Clock() / (100UL * prescale)) & 0xFFFF;
+	}
+
+	Host_TMR3H = (unsigned char)(host_timer3 >> 8);
+	host_timer3_low = (unsigned char)host_timer3;
+
+	return(&host_timer3_low);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		OpenADC(), ConvertADC(), BusyADC(), ReadADC(),
+*					CloseADC()
+*
+*	PURPOSE:		Stand in for the C18 A/D converter library.
+*
+*	CALLED FROM:	ifi_utilities.c/Get_Analog_Value()
+*
+*	PARAMETERS:		See the C18 library documentation.
+*
+*	RETURNS:		See the C18 library documentation.
+*
+*	COMMENTS:		Conversions finish at once.
+*
+*******************************************************************************/
+void OpenADC(unsigned char config, unsigned char config2, unsigned char portconfig)
+{
+	host_adc_channel = (config2 >> 3) & 0x0F;
+}
+
+void ConvertADC(void)
+{
+	Host_ADRESH = (unsigned char)(Host_Analog_Value[host_adc_channel] >> 8);
+	Host_ADRESL = (unsigned char)Host_Analog_Value[host_adc_channel];
+}
+
+char BusyADC(void)
+{
+	return(0);
+}
+
+int ReadADC(void)
+{
+	return(((int)Host_ADRESH << 8) | Host_ADRESL);
+}
+
+void CloseADC(void)
+{
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		IFI library and C18 library stand-ins
+*
+*	PURPOSE:		Stand in for the parts of FRC_library.lib and the C18
+*					libraries the robot code calls.
+*
+*	CALLED FROM:	main.c, user_routines.c, user_routines_fast.c,
+*					ifi_utilities.c
+*
+*	PARAMETERS:		See ifi_default.h, ifi_utilities.h, usart.h and
+*					p18cxxx.h.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The serial ports are set up through their registers
+*					by serial_ports.c, so opening them here does nothing.
+*
+*******************************************************************************/
+void IFI_Initialization(void)
+{
+	statusflag.NEW_SPI_DATA = 0;
+
+	// the transmitters are always ready
+	Host_TXSTA1.TRMT = 1;
+	Host_TXSTA2.TRMT = 1;
+	Host_PIR1.TX1IF = 1;
+	Host_PIR3.TX2IF = 1;
+
+	// Nothing is connected to the digital inputs, so the robot
+	// controller's pull-ups hold them high. Read as zero, every
+	// limit switch in Default_Routine() would be closed.
+	Host_PORTB.reg = 0xFF;
+	Host_PORTH.reg = 0xFF;
+	Host_PORTJ.reg = 0xFF;
+	Host_PORTC.RC0 = 1;
+
+	Host_INTCON.GIEH = 1;
+	Host_INTCON.GIEL = 1;
+}
+
+void User_Proc_Is_Ready(void)
+{
+	host_user_ready = 1;
+}
+
+void Setup_PWM_Output_Type(int pwmSpec1, int pwmSpec2, int pwmSpec3, int pwmSpec4)
+{
+}
+
+void Generate_Pwms(unsigned char pwm_13, unsigned char pwm_14,
+				   unsigned char pwm_15, unsigned char pwm_16)
+{
+}
+
+void Hex_output(unsigned char temp)
+{
+	static const char hex[] = "0123456789ABCDEF";
+
+	TXREG = hex[temp >> 4];
+	TXREG = hex[temp & 0x0F];
+}
+
+void Open1USART(unsigned char config, unsigned int spbrg)
+{
+}
+
+void Open2USART(unsigned char config, unsigned int spbrg)
+{
+}
+
+void Delay10TCYx(unsigned char count)
+{
+}
+
+void Delay100TCYx(unsigned char count)
+{
+}
+
+void Delay1KTCYx(unsigned char count)
+{
+}
+
+void Delay10KTCYx(unsigned char count)
+{
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_Stdout_Write()
+*
+*	PURPOSE:		Sends _H_USER output through _user_putc(), as C18 does.
+*
+*	CALLED FROM:	the C library, through the stream set up in
+*					Host_Start_Match()
+*
+*	PARAMETERS:		See fopencookie().
+*
+*	RETURNS:		Number of bytes written.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+static ssize_t Host_Stdout_Write(void *cookie, const char *buffer, size_t size)
+{
+	size_t i;
+
+	for(i = 0; i < size; i++)
+	{
+		_user_putc((unsigned char)buffer[i]);
+	}
+
+	return((ssize_t)size);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_Options()
+*
+*	PURPOSE:		Reads the command line.
+*
+*	CALLED FROM:	Host_Start_Match(), below.
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Exits with a usage message on a bad option.
+*
+*******************************************************************************/
+static void Host_Options(void)
+{
+	int option;
+
+	while((option = getopt(host_argc, host_argv, "m:s:v")) != -1)
+	{
+		switch(option)
+		{
+			case 'm':
+				host_matches = (unsigned int)strtoul(optarg, NULL, 0);
+				break;
+
+			case 's':
+				host_seed = (unsigned int)strtoul(optarg, NULL, 0);
+				break;
+
+			case 'v':
+				host_verbose = 1;
+				break;
+
+			default:
+				fprintf(stderr, "usage: %s [-m matches] [-s seed] [-v]\n", host_argv[0]);
+				exit(2);
+		}
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_Print_Match()
+*
+*	PURPOSE:		Prints one match's results.
+*
+*	CALLED FROM:	Host_Start_Match(), below.
+*
+*	PARAMETERS:		Match number and its results.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+static void Host_Print_Match(unsigned int match, Host_Match_Result_Type *result)
+{
+	printf("match %u: loop %lu/%lu/%lu ns, %lu T packets, aimed %lu, searching %lu, "
+		"shot ready %lu, pointing error %.1f deg, turret %.0f deg, signature %08lX\n",
+		match,
+		result->sim.min_ns,
+		result->sim.total_ns / (result->sim.loops ? result->sim.loops : 1),
+		result->sim.max_ns,
+		result->sim.t_packets,
+		result->sim.aimed_loops,
+		result->sim.searching_loops,
+		result->sim.shot_ready_loops,
+		result->in_view_loops ? result->pointing_error / result->in_view_loops : 0.0,
+		result->max_turret_angle,
+		result->sim.signature);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_Start_Match()
+*
+*	PURPOSE:		Runs the matches asked for on the command line, each in
+*					its own process, and prints a summary.
+*
+*	CALLED FROM:	sim.c/Sim_Initialize()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Seed for the match, in the match's process. The parent
+*					never returns.
+*
+*	COMMENTS:		The parent exits with status one if any match failed.
+*
+*******************************************************************************/
+unsigned int Host_Start_Match(void)
+{
+	Host_Match_Result_Type result;
+	Host_Match_Result_Type total;
+	unsigned long start;
+	unsigned long elapsed;
+	unsigned long combined;
+	unsigned int match;
+	unsigned int failures;
+	unsigned int i;
+	ssize_t count;
+	size_t received;
+	pid_t pid;
+	int fd[2];
+	int status;
+
+	Host_Options();
+
+	// power up state shared by every match
+	memset(host_eeprom, 0xFF, sizeof(host_eeprom));
+	for(i = 0; i < 16; i++)
+	{
+		Host_Analog_Value[i] = 512;
+	}
+
+	memset(&total, 0, sizeof(total));
+	total.sim.min_ns = 0xFFFFFFFFUL;
+	combined = 0;
+	failures = 0;
+	start = Host_Clock();
+
+	for(match = 0; match < host_matches; match++)
+	{
+		if(pipe(fd) != 0)
+		{
+			perror("pipe");
+			exit(1);
+		}
+
+		fflush(stdout);
+
+		pid = fork();
+
+		if(pid < 0)
+		{
+			perror("fork");
+			exit(1);
+		}
+
+		if(pid == 0)
+		{
+			cookie_io_functions_t functions = {NULL, Host_Stdout_Write, NULL, NULL};
+
+			close(fd[0]);
+			host_result_fd = fd[1];
+			alarm(HOST_MATCH_TIMEOUT);
+
+			host_terminal = stdout;
+			Host_User_Stream = fopencookie(NULL, "w", functions);
+			setvbuf(Host_User_Stream, NULL, _IONBF, 0);
+
+			Camera_Model_Initialize(host_seed + match);
+
+			return(host_seed + match);
+		}
+
+		close(fd[1]);
+
+		received = 0;
+		while(received < sizeof(result))
+		{
+			count = read(fd[0], (char *)&result + received, sizeof(result) - received);
+			if(count <= 0)
+			{
+				break;
+			}
+			received += (size_t)count;
+		}
+
+		close(fd[0]);
+		waitpid(pid, &status, 0);
+
+		if(received != sizeof(result) || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		{
+			fprintf(stderr, "match %u (seed %u) failed\n", match, host_seed + match);
+			failures++;
+			continue;
+		}
+
+		if(host_verbose)
+		{
+			Host_Print_Match(match, &result);
+		}
+
+		total.sim.loops += result.sim.loops;
+		total.sim.total_ns += result.sim.total_ns;
+		if(result.sim.min_ns < total.sim.min_ns)
+		{
+			total.sim.min_ns = result.sim.min_ns;
+		}
+		if(result.sim.max_ns > total.sim.max_ns)
+		{
+			total.sim.max_ns = result.sim.max_ns;
+		}
+		total.sim.t_packets += result.sim.t_packets;
+		total.sim.aimed_loops += result.sim.aimed_loops;
+		total.sim.searching_loops += result.sim.searching_loops;
+		total.sim.shot_ready_loops += result.sim.shot_ready_loops;
+		if(result.camera_tx_max > total.camera_tx_max)
+		{
+			total.camera_tx_max = result.camera_tx_max;
+		}
+		if(result.terminal_tx_max > total.terminal_tx_max)
+		{
+			total.terminal_tx_max = result.terminal_tx_max;
+		}
+		total.uart_over_budget += result.uart_over_budget;
+		total.rx_overruns += result.rx_overruns;
+		total.in_view_loops += result.in_view_loops;
+		total.pointing_error += result.pointing_error;
+		total.turret_stop_loops += result.turret_stop_loops;
+		if(result.max_turret_angle > total.max_turret_angle)
+		{
+			total.max_turret_angle = result.max_turret_angle;
+		}
+
+		combined = (combined * 31 + result.sim.signature) & 0xFFFFFFFFUL;
+	}
+
+	elapsed = Host_Clock() - start;
+
+	if(total.sim.loops == 0)
+	{
+		total.sim.loops = 1;
+		total.sim.min_ns = 0;
+	}
+	if(total.in_view_loops == 0)
+	{
+		total.in_view_loops = 1;
+	}
+
+	printf("%u matches in %.1f s (%.0f matches/minute), %u failed\n",
+		host_matches,
+		elapsed / 1e9,
+		elapsed ? host_matches * 60e9 / elapsed : 0.0,
+		failures);
+	printf("slow loop cost on this host: min %lu, mean %lu, max %lu ns\n",
+		total.sim.min_ns,
+		total.sim.total_ns / total.sim.loops,
+		total.sim.max_ns);
+	printf("camera: %.0f T packets/match, target in view %.1f%% of loops, "
+		"mean pointing error %.1f deg\n",
+		host_matches ? (double)total.sim.t_packets / host_matches : 0.0,
+		100.0 * total.in_view_loops / total.sim.loops,
+		total.pointing_error / total.in_view_loops);
+	printf("tracking: aimed %.1f%%, searching %.1f%%, shot ready %.1f%% of loops\n",
+		100.0 * total.sim.aimed_loops / total.sim.loops,
+		100.0 * total.sim.searching_loops / total.sim.loops,
+		100.0 * total.sim.shot_ready_loops / total.sim.loops);
+	printf("turret: farthest %.0f deg from ahead, %lu loops against a stop\n",
+		total.max_turret_angle,
+		total.turret_stop_loops);
+	printf("serial: at most %lu bytes/loop to the camera, %lu to the terminal, "
+		"%lu loops over %u bytes, %lu camera bytes lost\n",
+		total.camera_tx_max,
+		total.terminal_tx_max,
+		total.uart_over_budget,
+		HOST_UART_BYTES_PER_LOOP,
+		total.rx_overruns);
+	printf("signature %08lX\n", combined);
+
+	exit(failures ? 1 : 0);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_Advance()
+*
+*	PURPOSE:		Moves the world on by one slow loop.
+*
+*	CALLED FROM:	sim.c/Sim_Putdata()
+*
+*	PARAMETERS:		The frame being sent to the master uP.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Everything the camera sends during the slow loop
+*					arrives here, before the next frame is flagged.
+*
+*******************************************************************************/
+void Host_Advance(tx_data_ptr ptr)
+{
+	unsigned char port;
+	unsigned char byte;
+
+	for(port = 1; port <= 2; port++)
+	{
+		Host_Flush_TX(port);
+
+		if(host_tx_loop_bytes[port] > host_tx_max[port])
+		{
+			host_tx_max[port] = host_tx_loop_bytes[port];
+		}
+		if(host_tx_loop_bytes[port] > HOST_UART_BYTES_PER_LOOP)
+		{
+			host_uart_over_budget++;
+		}
+		host_tx_loop_bytes[port] = 0;
+	}
+
+	Camera_Model_Step(ptr);
+
+	while(Camera_Model_Transmit(&byte))
+	{
+		Host_Receive(HOST_CAMERA_PORT, byte);
+	}
+
+	host_frame_ready = 1;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Host_End_Match()
+*
+*	PURPOSE:		Sends the match results to the parent and exits.
+*
+*	CALLED FROM:	sim.c/Sim_Report()
+*
+*	PARAMETERS:		Results from sim.c.
+*
+*	RETURNS:		Doesn't.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+void Host_End_Match(Sim_Match_Result_Type *sim)
+{
+	Host_Match_Result_Type result;
+
+	memset(&result, 0, sizeof(result));
+	result.sim = *sim;
+	result.camera_tx_max = host_tx_max[HOST_CAMERA_PORT];
+	result.terminal_tx_max = host_tx_max[HOST_TERMINAL_PORT];
+	result.uart_over_budget = host_uart_over_budget;
+	result.rx_overruns = host_rx_overruns;
+	Camera_Model_Results(&result);
+
+	fflush(host_terminal);
+
+	if(write(host_result_fd, &result, sizeof(result)) != sizeof(result))
+	{
+		_exit(1);
+	}
+
+	_exit(0);
+}
@@ -0,0 +1,61 @@
+/*******************************************************************************
+*
+*	TITLE:		host.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Host build of the robot controller. See host.c for
+*				details.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _HOST_H
+#define _HOST_H
+
+// time between frames from the master uP
+#define HOST_LOOP_MICROSECONDS 26214
+
+// Bytes each serial port can send in one slow loop at 115200 baud,
+// with a start and a stop bit on every byte.
+#define HOST_UART_BYTES_PER_LOOP 301
+
+// number of matches to run if -m isn't given
+#define HOST_DEFAULT_MATCHES 1000
+
+// what the host adds to each match result from sim.c
+typedef struct
+{
+	Sim_Match_Result_Type sim;
+	unsigned long camera_tx_max;		// most bytes sent to the camera in one slow loop
+	unsigned long terminal_tx_max;		// most bytes sent to the terminal in one slow loop
+	unsigned long uart_over_budget;		// slow loops that sent more than HOST_UART_BYTES_PER_LOOP
+	unsigned long rx_overruns;			// camera bytes lost because the receiver was off
+	unsigned long in_view_loops;		// slow loops with the target in the camera's view
+	double pointing_error;				// sum of |turret bearing error|, in degrees, while in view
+	unsigned long turret_stop_loops;	// slow loops spent against a turret travel stop
+	double max_turret_angle;			// farthest the turret got from straight ahead, in degrees
+}	Host_Match_Result_Type;
+
+// process and match control, in host.c
+unsigned int Host_Start_Match(void);
+void Host_Advance(tx_data_ptr);
+void Host_End_Match(Sim_Match_Result_Type *);
+unsigned long Host_Clock(void);
+
+// CMUcam2 and robot model, in camera_model.c
+void Camera_Model_Initialize(unsigned int);
+void Camera_Model_Receive(unsigned char);
+void Camera_Model_Step(tx_data_ptr);
+unsigned char Camera_Model_Transmit(unsigned char *);
+void Camera_Model_Results(Host_Match_Result_Type *);
+
+#endif
@@ -0,0 +1,29 @@
+/*******************************************************************************
+*
+*	TITLE:		camera_menu.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Host build stand-in for camera_menu.h, which isn't in
+*				this tree. See missing.c.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _CAMERA_MENU_H
+#define _CAMERA_MENU_H
+
+// terminal key that opens the camera menu
+#define CM_SETUP_KEY 'c'
+
+unsigned char Camera_Menu(void);
+
+#endif
@@ -0,0 +1,40 @@
+/*******************************************************************************
+*
+*	TITLE:		missing.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	user_routines.c calls into camera_menu.c, tracking_menu.c
+*				and terminal.c, which aren't in this tree. These stand-ins
+*				let the host build link. The menus close as soon as they're
+*				opened and the diagnostic printout sends nothing, so none
+*				of their cost shows up in the simulator's numbers.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include "camera_menu.h"
+#include "tracking_menu.h"
+#include "terminal.h"
+
+unsigned char Camera_Menu(void)
+{
+	return(0);
+}
+
+unsigned char Tracking_Menu(void)
+{
+	return(0);
+}
+
+void Tracking_Info_Terminal(void)
+{
+}
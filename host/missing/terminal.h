@@ -0,0 +1,26 @@
+/*******************************************************************************
+*
+*	TITLE:		terminal.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Host build stand-in for terminal.h, which isn't in this
+*				tree. See missing.c.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _TERMINAL_H
+#define _TERMINAL_H
+
+void Tracking_Info_Terminal(void);
+
+#endif
@@ -0,0 +1,29 @@
+/*******************************************************************************
+*
+*	TITLE:		tracking_menu.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Host build stand-in for tracking_menu.h, which isn't in
+*				this tree. See missing.c.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _TRACKING_MENU_H
+#define _TRACKING_MENU_H
+
+// terminal key that opens the tracking menu
+#define TM_SETUP_KEY 't'
+
+unsigned char Tracking_Menu(void);
+
+#endif
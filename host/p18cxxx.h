@@ -0,0 +1,57 @@
+/*******************************************************************************
+*
+*	TITLE:		p18cxxx.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Host build stand-in for the C18 processor header. Pulls in
+*				the PIC18F8722 register definitions and maps the C18
+*				language extensions and built-in instructions the robot
+*				code uses onto plain C.
+*
+*				This is only used by the host build (see host/Makefile).
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _P18CXXX_H
+#define _P18CXXX_H
+
+#include "p18f8722.h"
+
+// the processor C18 would have been told to build for
+#define __18F8722 1
+
+// C18 memory qualifiers
+#define rom
+#define ram
+#define near
+#define far
+#define overlay
+
+// C18 built-in instructions
+#define Nop()
+#define ClrWdt()
+#define Sleep()
+#define Reset()
+
+// The C18 delays.h declares its parameters with a storage class,
+// which isn't legal C, so it's kept out and the delays are declared
+// here instead. They return right away (see host.c).
+#define __DELAYS_H
+#define Delay1TCY()
+#define Delay10TCY()
+void Delay10TCYx(unsigned char);
+void Delay100TCYx(unsigned char);
+void Delay1KTCYx(unsigned char);
+void Delay10KTCYx(unsigned char);
+
+#endif
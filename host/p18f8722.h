@@ -0,0 +1,470 @@
+/*******************************************************************************
+*
+*	TITLE:		p18f8722.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Host build stand-in for the C18 PIC18F8722 register
+*				definitions. Only the registers and bits the robot code
+*				uses are here, laid out like the real ones.
+*
+*				Most registers are plain memory. A few have side effects
+*				on the real part, so their names expand to a call into
+*				host.c before the access:
+*
+*				  PIE1bits, PIE3bits, INTCONbits: the code turns interrupts
+*				  on and off through these, so each access first runs any
+*				  interrupt that's pending and enabled (see Host_Poll()).
+*
+*				  EECON1bits, PIR2bits, EEDATA: carry out a pending EEPROM
+*				  read or write (see Host_EEPROM_Clock()).
+*
+*				  TXREG1, TXREG2: hand the byte to the serial port model.
+*
+*				  RCREG1, RCREG2: clear the receive interrupt flag.
+*
+*				  TMR3L: Timer3 runs from the host clock and latches TMR3H
+*				  when TMR3L is read, like the real timer in 16-bit mode.
+*
+*				This is only used by the host build (see host/Makefile).
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _P18F8722_H
+#define _P18F8722_H
+
+// The Makefile #define's HOST_SFR_STORAGE when it builds host.c, which
+// holds the one definition of each register.
+#ifdef HOST_SFR_STORAGE
+#define HOST_SFR
+#else
+#define HOST_SFR extern
+#endif
+
+typedef union
+{
+	unsigned char reg;
+	struct
+	{
+		unsigned char RBIF:1;
+		unsigned char INT0IF:1;
+		unsigned char TMR0IF:1;
+		unsigned char RBIE:1;
+		unsigned char INT0IE:1;
+		unsigned char TMR0IE:1;
+		unsigned char GIEL:1;
+		unsigned char GIEH:1;
+	};
+	struct
+	{
+		unsigned char :6;
+		unsigned char PEIE:1;
+		unsigned char GIE:1;
+	};
+}	Host_INTCON_Type;
+
+typedef union
+{
+	unsigned char reg;
+	struct
+	{
+		unsigned char INT1IF:1;
+		unsigned char INT2IF:1;
+		unsigned char INT3IF:1;
+		unsigned char INT1IE:1;
+		unsigned char INT2IE:1;
+		unsigned char INT3IE:1;
+		unsigned char INT1IP:1;
+		unsigned char INT2IP:1;
+	};
+}	Host_INTCON3_Type;
+
+// PIR1, PIE1 and IPR1 share a layout
+typedef union
+{
+	unsigned char reg;
+	struct
+	{
+		unsigned char TMR1IF:1;
+		unsigned char TMR2IF:1;
+		unsigned char CCP1IF:1;
+		unsigned char SSPIF:1;
+		unsigned char TX1IF:1;
+		unsigned char RC1IF:1;
+		unsigned char ADIF:1;
+		unsigned char PSPIF:1;
+	};
+	struct
+	{
+		unsigned char TMR1IE:1;
+		unsigned char TMR2IE:1;
+		unsigned char CCP1IE:1;
+		unsigned char SSPIE:1;
+		unsigned char TX1IE:1;
+		unsigned char RC1IE:1;
+		unsigned char ADIE:1;
+		unsigned char PSPIE:1;
+	};
+	struct
+	{
+		unsigned char TMR1IP:1;
+		unsigned char TMR2IP:1;
+		unsigned char CCP1IP:1;
+		unsigned char SSPIP:1;
+		unsigned char TX1IP:1;
+		unsigned char RC1IP:1;
+		unsigned char ADIP:1;
+		unsigned char PSPIP:1;
+	};
+	struct
+	{
+		unsigned char :4;
+		unsigned char TXIF:1;
+		unsigned char RCIF:1;
+	};
+	struct
+	{
+		unsigned char :4;
+		unsigned char TXIE:1;
+		unsigned char RCIE:1;
+	};
+	struct
+	{
+		unsigned char :4;
+		unsigned char TXIP:1;
+		unsigned char RCIP:1;
+	};
+}	Host_PIR1_Type;
+
+typedef union
+{
+	unsigned char reg;
+	struct
+	{
+		unsigned char CCP2IF:1;
+		unsigned char TMR3IF:1;
+		unsigned char HLVDIF:1;
+		unsigned char BCL1IF:1;
+		unsigned char EEIF:1;
+		unsigned char :1;
+		unsigned char CMIF:1;
+		unsigned char OSCFIF:1;
+	};
+}	Host_PIR2_Type;
+
+// PIR3, PIE3 and IPR3 share a layout
+typedef union
+{
+	unsigned char reg;
+	struct
+	{
+		unsigned char CCP3IF:1;
+		unsigned char CCP4IF:1;
+		unsigned char CCP5IF:1;
+		unsigned char TMR4IF:1;
+		unsigned char TX2IF:1;
+		unsigned char RC2IF:1;
+		unsigned char BCL2IF:1;
+		unsigned char SSP2IF:1;
+	};
+	struct
+	{
+		unsigned char CCP3IE:1;
+		unsigned char CCP4IE:1;
+		unsigned char CCP5IE:1;
+		unsigned char TMR4IE:1;
+		unsigned char TX2IE:1;
+		unsigned char RC2IE:1;
+		unsigned char BCL2IE:1;
+		unsigned char SSP2IE:1;
+	};
+	struct
+	{
+		unsigned char CCP3IP:1;
+		unsigned char CCP4IP:1;
+		unsigned char CCP5IP:1;
+		unsigned char TMR4IP:1;
+		unsigned char TX2IP:1;
+		unsigned char RC2IP:1;
+		unsigned char BCL2IP:1;
+		unsigned char SSP2IP:1;
+	};
+}	Host_PIR3_Type;
+
+typedef union
+{
+	unsigned char reg;
+	struct
+	{
+		unsigned char RX9D:1;
+		unsigned char OERR:1;
+		unsigned char FERR:1;
+		unsigned char ADDEN:1;
+		unsigned char CREN:1;
+		unsigned char SREN:1;
+		unsigned char RX9:1;
+		unsigned char SPEN:1;
+	};
+}	Host_RCSTA_Type;
+
+typedef union
+{
+	unsigned char reg;
+	struct
+	{
+		unsigned char TX9D:1;
+		unsigned char TRMT:1;
+		unsigned char BRGH:1;
+		unsigned char SENDB:1;
+		unsigned char SYNC:1;
+		unsigned char TXEN:1;
+		unsigned char TX9:1;
+		unsigned char CSRC:1;
+	};
+}	Host_TXSTA_Type;
+
+typedef union
+{
+	unsigned char reg;
+	struct
+	{
+		unsigned char RD:1;
+		unsigned char WR:1;
+		unsigned char WREN:1;
+		unsigned char WRERR:1;
+		unsigned char FREE:1;
+		unsigned char :1;
+		unsigned char CFGS:1;
+		unsigned char EEPGD:1;
+	};
+}	Host_EECON1_Type;
+
+typedef union
+{
+	unsigned char reg;
+	struct
+	{
+		unsigned char T2CKPS0:1;
+		unsigned char T2CKPS1:1;
+		unsigned char TMR2ON:1;
+		unsigned char T2OUTPS0:1;
+		unsigned char T2OUTPS1:1;
+		unsigned char T2OUTPS2:1;
+		unsigned char T2OUTPS3:1;
+		unsigned char :1;
+	};
+}	Host_T2CON_Type;
+
+typedef union
+{
+	unsigned char reg;
+	struct
+	{
+		unsigned char TMR3ON:1;
+		unsigned char TMR3CS:1;
+		unsigned char T3SYNC:1;
+		unsigned char T3CCP1:1;
+		unsigned char T3CKPS0:1;
+		unsigned char T3CKPS1:1;
+		unsigned char T3CCP2:1;
+		unsigned char RD16:1;
+	};
+}	Host_T3CON_Type;
+
+// The PORTx, LATx and TRISx registers of each I/O port.
+#define HOST_IO_PORT(x) \
+typedef union \
+{ \
+	unsigned char reg; \
+	struct \
+	{ \
+		unsigned char R##x##0:1, R##x##1:1, R##x##2:1, R##x##3:1; \
+		unsigned char R##x##4:1, R##x##5:1, R##x##6:1, R##x##7:1; \
+	}; \
+}	Host_PORT##x##_Type; \
+typedef union \
+{ \
+	unsigned char reg; \
+	struct \
+	{ \
+		unsigned char LAT##x##0:1, LAT##x##1:1, LAT##x##2:1, LAT##x##3:1; \
+		unsigned char LAT##x##4:1, LAT##x##5:1, LAT##x##6:1, LAT##x##7:1; \
+	}; \
+}	Host_LAT##x##_Type; \
+typedef union \
+{ \
+	unsigned char reg; \
+	struct \
+	{ \
+		unsigned char TRIS##x##0:1, TRIS##x##1:1, TRIS##x##2:1, TRIS##x##3:1; \
+		unsigned char TRIS##x##4:1, TRIS##x##5:1, TRIS##x##6:1, TRIS##x##7:1; \
+	}; \
+}	Host_TRIS##x##_Type; \
+HOST_SFR Host_PORT##x##_Type Host_PORT##x; \
+HOST_SFR Host_LAT##x##_Type Host_LAT##x; \
+HOST_SFR Host_TRIS##x##_Type Host_TRIS##x;
+
+HOST_IO_PORT(A)
+HOST_IO_PORT(B)
+HOST_IO_PORT(C)
+HOST_IO_PORT(D)
+HOST_IO_PORT(E)
+HOST_IO_PORT(F)
+HOST_IO_PORT(G)
+HOST_IO_PORT(H)
+HOST_IO_PORT(J)
+
+HOST_SFR Host_INTCON_Type Host_INTCON;
+HOST_SFR Host_INTCON3_Type Host_INTCON3;
+HOST_SFR Host_PIR1_Type Host_PIR1;
+HOST_SFR Host_PIR1_Type Host_PIE1;
+HOST_SFR Host_PIR1_Type Host_IPR1;
+HOST_SFR Host_PIR2_Type Host_PIR2;
+HOST_SFR Host_PIR3_Type Host_PIR3;
+HOST_SFR Host_PIR3_Type Host_PIE3;
+HOST_SFR Host_PIR3_Type Host_IPR3;
+HOST_SFR Host_RCSTA_Type Host_RCSTA1;
+HOST_SFR Host_RCSTA_Type Host_RCSTA2;
+HOST_SFR Host_TXSTA_Type Host_TXSTA1;
+HOST_SFR Host_TXSTA_Type Host_TXSTA2;
+HOST_SFR Host_EECON1_Type Host_EECON1;
+HOST_SFR Host_T2CON_Type Host_T2CON;
+HOST_SFR Host_T3CON_Type Host_T3CON;
+HOST_SFR unsigned char Host_SPBRG1;
+HOST_SFR unsigned char Host_SPBRG2;
+HOST_SFR unsigned char Host_EEADR;
+HOST_SFR unsigned char Host_EEADRH;
+HOST_SFR unsigned char Host_EEDATA;
+HOST_SFR unsigned char Host_EECON2;
+HOST_SFR unsigned char Host_TMR3H;
+HOST_SFR unsigned char Host_ADRESH;
+HOST_SFR unsigned char Host_ADRESL;
+HOST_SFR unsigned char Host_PROD;
+
+// register side effects, in host.c
+void Host_Poll(void);
+void Host_EEPROM_Clock(void);
+unsigned char *Host_TXREG(unsigned char port);
+unsigned char *Host_RCREG(unsigned char port);
+unsigned char *Host_TMR3L(void);
+
+#define PORTA Host_PORTA.reg
+#define PORTB Host_PORTB.reg
+#define PORTC Host_PORTC.reg
+#define PORTD Host_PORTD.reg
+#define PORTE Host_PORTE.reg
+#define PORTF Host_PORTF.reg
+#define PORTG Host_PORTG.reg
+#define PORTH Host_PORTH.reg
+#define PORTJ Host_PORTJ.reg
+#define PORTAbits Host_PORTA
+#define PORTBbits Host_PORTB
+#define PORTCbits Host_PORTC
+#define PORTDbits Host_PORTD
+#define PORTEbits Host_PORTE
+#define PORTFbits Host_PORTF
+#define PORTGbits Host_PORTG
+#define PORTHbits Host_PORTH
+#define PORTJbits Host_PORTJ
+
+#define LATA Host_LATA.reg
+#define LATB Host_LATB.reg
+#define LATC Host_LATC.reg
+#define LATD Host_LATD.reg
+#define LATE Host_LATE.reg
+#define LATF Host_LATF.reg
+#define LATG Host_LATG.reg
+#define LATH Host_LATH.reg
+#define LATJ Host_LATJ.reg
+#define LATAbits Host_LATA
+#define LATBbits Host_LATB
+#define LATCbits Host_LATC
+#define LATDbits Host_LATD
+#define LATEbits Host_LATE
+#define LATFbits Host_LATF
+#define LATGbits Host_LATG
+#define LATHbits Host_LATH
+#define LATJbits Host_LATJ
+
+#define TRISA Host_TRISA.reg
+#define TRISB Host_TRISB.reg
+#define TRISC Host_TRISC.reg
+#define TRISD Host_TRISD.reg
+#define TRISE Host_TRISE.reg
+#define TRISF Host_TRISF.reg
+#define TRISG Host_TRISG.reg
+#define TRISH Host_TRISH.reg
+#define TRISJ Host_TRISJ.reg
+#define TRISAbits Host_TRISA
+#define TRISBbits Host_TRISB
+#define TRISCbits Host_TRISC
+#define TRISDbits Host_TRISD
+#define TRISEbits Host_TRISE
+#define TRISFbits Host_TRISF
+#define TRISGbits Host_TRISG
+#define TRISHbits Host_TRISH
+#define TRISJbits Host_TRISJ
+
+#define INTCON (*(Host_Poll(), &Host_INTCON.reg))
+#define INTCONbits (*(Host_Poll(), &Host_INTCON))
+#define INTCON3 Host_INTCON3.reg
+#define INTCON3bits Host_INTCON3
+
+#define PIR1 Host_PIR1.reg
+#define PIR1bits Host_PIR1
+#define PIE1 (*(Host_Poll(), &Host_PIE1.reg))
+#define PIE1bits (*(Host_Poll(), &Host_PIE1))
+#define IPR1 Host_IPR1.reg
+#define IPR1bits Host_IPR1
+#define PIR2 (*(Host_EEPROM_Clock(), &Host_PIR2.reg))
+#define PIR2bits (*(Host_EEPROM_Clock(), &Host_PIR2))
+#define PIR3 Host_PIR3.reg
+#define PIR3bits Host_PIR3
+#define PIE3 (*(Host_Poll(), &Host_PIE3.reg))
+#define PIE3bits (*(Host_Poll(), &Host_PIE3))
+#define IPR3 Host_IPR3.reg
+#define IPR3bits Host_IPR3
+
+#define RCSTA1 Host_RCSTA1.reg
+#define RCSTA1bits Host_RCSTA1
+#define RCSTA2 Host_RCSTA2.reg
+#define RCSTA2bits Host_RCSTA2
+#define TXSTA1 Host_TXSTA1.reg
+#define TXSTA1bits Host_TXSTA1
+#define TXSTA2 Host_TXSTA2.reg
+#define TXSTA2bits Host_TXSTA2
+#define SPBRG1 Host_SPBRG1
+#define SPBRG2 Host_SPBRG2
+#define TXREG1 (*Host_TXREG(1))
+#define TXREG2 (*Host_TXREG(2))
+#define RCREG1 (*Host_RCREG(1))
+#define RCREG2 (*Host_RCREG(2))
+
+#define EECON1 (*(Host_EEPROM_Clock(), &Host_EECON1.reg))
+#define EECON1bits (*(Host_EEPROM_Clock(), &Host_EECON1))
+#define EECON2 Host_EECON2
+#define EEADR Host_EEADR
+#define EEADRH Host_EEADRH
+#define EEDATA (*(Host_EEPROM_Clock(), &Host_EEDATA))
+
+#define T2CON Host_T2CON.reg
+#define T2CONbits Host_T2CON
+#define T3CON Host_T3CON.reg
+#define T3CONbits Host_T3CON
+#define TMR3L (*Host_TMR3L())
+#define TMR3H Host_TMR3H
+
+#define ADRESH Host_ADRESH
+#define ADRESL Host_ADRESL
+#define PROD Host_PROD
+
+#endif
@@ -0,0 +1,28 @@
+/*******************************************************************************
+*
+*	TITLE:		stdio.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Host build wrapper for the C library's stdio.h that adds
+*				C18's _H_USER stream handle. serial_ports.c points stdout
+*				at it so that printf() goes through _user_putc(). On the
+*				host it's a stream set up by host.c that does the same.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include_next <stdio.h>
+
+#ifndef _H_USER
+extern FILE *Host_User_Stream;
+#define _H_USER Host_User_Stream
+#endif
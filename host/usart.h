@@ -0,0 +1,35 @@
+/*******************************************************************************
+*
+*	TITLE:		usart.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Host build stand-in for the C18 USART library. The robot
+*				code sets up its serial ports through the registers (see
+*				serial_ports.c), so opening a port here does nothing.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _USART_H
+#define _USART_H
+
+#define USART_TX_INT_OFF 0xFF
+#define USART_RX_INT_OFF 0xFF
+#define USART_ASYNCH_MODE 0xFF
+#define USART_EIGHT_BIT 0xFF
+#define USART_CONT_RX 0xFF
+#define USART_BRGH_HIGH 0xFF
+
+void Open1USART(unsigned char, unsigned int);
+void Open2USART(unsigned char, unsigned int);
+
+#endif
@@ -15,6 +15,7 @@
 #include "ifi_default.h"
 #include "ifi_utilities.h"
 #include "user_routines.h"
+#include "sim.h"
 
 tx_data_record txdata;          /* DO NOT CHANGE! */
 rx_data_record rxdata;          /* DO NOT CHANGE! */
@@ -30,6 +31,10 @@ packed_struct statusflag;       /* DO NOT CHANGE! */
 *******************************************************************************/
 void main (void)
 {
+#ifdef _SIMULATOR
+  Sim_Initialize();             /* Stand-in master uP, see sim.c */
+#endif
+
 #ifdef UNCHANGEABLE_DEFINITION_AREA
   IFI_Initialization ();        /* DO NOT CHANGE! */
 #endif
@@ -40,10 +45,6 @@ void main (void)
 
   while (1)   /* This loop will repeat indefinitely. */
   {
-#ifdef _SIMULATOR
-    statusflag.NEW_SPI_DATA = 1;
-#endif
-
     if (statusflag.NEW_SPI_DATA)      /* 26.2ms loop area */
     {                                 /* I'm slow!  I only execute every 26.2ms because */
                                       /* that's how fast the Master uP gives me data. */
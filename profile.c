@@ -0,0 +1,489 @@
+/*******************************************************************************
+*
+*	TITLE:		profile.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	This file implements a cycle budget profiler for the
+*				26.2ms slow loop.
+*
+*				Timer3 is run freely from the instruction clock and each
+*				stage of Process_Data_From_Master_uP() is bracketed with
+*				PROFILE_START()/PROFILE_STOP(). Per-stage minimum, maximum
+*				and mean cycle counts are kept in RAM along with a ring
+*				holding each stage's cost over the last PROFILE_RING_SIZE
+*				slow loops, so the loop that blew the SPI window can be
+*				found after the fact.
+*
+*				Pressing control-P on the terminal calls Profile_Dump(),
+*				which sends the statistics as one compact binary frame
+*				instead of printf() text. The frame goes out a few bytes
+*				at a time at the end of each slow loop (see
+*				PROFILE_DUMP_BYTES_PER_LOOP), so sending it never makes
+*				the slow loop wait for the serial port. The statistics
+*				and the ring are frozen while the frame is being sent,
+*				so the frame describes the slow loops before the dump
+*				and not the dump itself, and are cleared afterwards.
+*				The frame layout is:
+*
+*				  byte 0     PROFILE_FRAME_SYNC_1 (0xFF)
+*				  byte 1     PROFILE_FRAME_SYNC_2 ('P')
+*				  byte 2     PROFILE_STAGE_COUNT
+*				  byte 3     PROFILE_TIMER_PRESCALE (cycles per tick)
+*				  byte 4     PROFILE_RING_SIZE
+*				  then, for each stage, in PROFILE_xxx order:
+*				    min ticks, max ticks, mean ticks (16 bits each,
+*				    high byte first)
+*				  then every ring entry, oldest first, each holding
+*				    every stage in PROFILE_xxx order (16 bits each,
+*				    high byte first). The last entry is the slow loop
+*				    the dump was made from, so it only holds the
+*				    stages that finished before the dump.
+*				  last byte  eight-bit sum of all preceding bytes
+*
+*				Remove the instrumentation by commenting out the
+*				#define ENABLE_PROFILING line in profile.h.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include <p18f8722.h>
+#include "camera.h"
+#include "profile.h"
+
+#ifdef ENABLE_PROFILING
+
+// per-stage statistics since the last dump
+Profile_Stage_Type Profile_Stage[PROFILE_STAGE_COUNT];
+
+// per-stage cost of the last PROFILE_RING_SIZE slow loops
+unsigned int Profile_Ring[PROFILE_RING_SIZE][PROFILE_STAGE_COUNT];
+
+// ring slot being filled during the current slow loop
+unsigned char profile_ring_index = 0;
+
+// timer value recorded by Profile_Start() for each stage
+static unsigned int profile_start_ticks[PROFILE_STAGE_COUNT];
+
+// bit n is set if stage n ran during the current slow loop
+static unsigned char profile_stages_run = 0;
+
+// set while a profile frame is being sent, which freezes
+// the statistics and the ring
+static unsigned char profile_dump_active = 0;
+
+// next byte of the frame to send and running checksum of the
+// bytes sent so far
+static unsigned int profile_dump_offset;
+static unsigned char profile_checksum;
+
+static void Profile_Dump_Send(void);
+
+#endif
+
+/*******************************************************************************
+*
+*	FUNCTION:		Profile_Initialize_Timer()
+*
+*	PURPOSE:		Starts Timer3 running freely from the instruction clock.
+*
+*	CALLED FROM:	user_routines.c/User_Initialization(), sim.c
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Timer0 belongs to Generate_Pwms() in FRC_library.lib,
+*					so Timer3 is used instead. Calling this more than once
+*					is harmless.
+*
+*******************************************************************************/
+void Profile_Initialize_Timer(void)
+{
+	if(T3CONbits.TMR3ON == 0)
+	{
+		T3CON = 0;
+		T3CONbits.RD16 = 1;		// 16-bit read/write mode
+		T3CONbits.T3CKPS1 = 1;	// 1:8 prescale (see PROFILE_TIMER_PRESCALE)
+		T3CONbits.T3CKPS0 = 1;
+		TMR3H = 0;
+		TMR3L = 0;
+		T3CONbits.TMR3ON = 1;
+	}
+
+	#ifdef ENABLE_PROFILING
+	Profile_Reset();
+	#endif
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Profile_Read_Timer()
+*
+*	PURPOSE:		Returns the current 16-bit value of Timer3.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		unsigned int
+*
+*	COMMENTS:		Timer3 is in 16-bit read/write mode, so reading TMR3L
+*					latches TMR3H and the two halves are always consistent.
+*					Differences between two readings are correct across a
+*					timer wrap as long as they are less than 65536 ticks
+*					apart.
+*
+*******************************************************************************/
+unsigned int Profile_Read_Timer(void)
+{
+	unsigned char low;
+
+	low = TMR3L;
+	return(((unsigned int)TMR3H << 8) | (unsigned int)low);
+}
+
+#ifdef ENABLE_PROFILING
+
+/*******************************************************************************
+*
+*	FUNCTION:		Profile_Start()
+*
+*	PURPOSE:		Marks the entry of a profiled stage.
+*
+*	CALLED FROM:	user_routines.c/Process_Data_From_Master_uP(), via the
+*					PROFILE_START() macro
+*
+*	PARAMETERS:		Stage number (PROFILE_xxx in profile.h).
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+void Profile_Start(unsigned char stage)
+{
+	profile_start_ticks[stage] = Profile_Read_Timer();
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Profile_Stop()
+*
+*	PURPOSE:		Marks the exit of a profiled stage and adds the time
+*					spent in it to the current slow loop's ring entry.
+*
+*	CALLED FROM:	user_routines.c/Process_Data_From_Master_uP(), via the
+*					PROFILE_STOP() macro
+*
+*	PARAMETERS:		Stage number (PROFILE_xxx in profile.h).
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		A stage may be entered more than once per slow loop
+*					(e.g., the terminal output and the menu handling are
+*					both charged to PROFILE_TERMINAL); the times are summed.
+*
+*******************************************************************************/
+void Profile_Stop(unsigned char stage)
+{
+	if(profile_dump_active == 1)
+	{
+		return;
+	}
+
+	Profile_Ring[profile_ring_index][stage] += Profile_Read_Timer() - profile_start_ticks[stage];
+
+	profile_stages_run |= (unsigned char)(1 << stage);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Profile_End_Of_Loop()
+*
+*	PURPOSE:		Updates the per-stage statistics with the slow loop
+*					that just finished and advances the history ring.
+*
+*	CALLED FROM:	user_routines.c/Process_Data_From_Master_uP(), via the
+*					PROFILE_END_OF_LOOP() macro
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Stages that don't run during a slow loop are recorded
+*					in the ring as zero.
+*
+*					While a profile frame is being sent, this sends the
+*					next part of it instead.
+*
+*******************************************************************************/
+void Profile_End_Of_Loop(void)
+{
+	unsigned char i;
+	unsigned int ticks;
+	Profile_Stage_Type *p;
+
+	if(profile_dump_active == 1)
+	{
+		Profile_Dump_Send();
+		return;
+	}
+
+	// fold this slow loop's stage times into the statistics
+	for(i = 0; i < PROFILE_STAGE_COUNT; i++)
+	{
+		if(profile_stages_run & (1 << i))
+		{
+			ticks = Profile_Ring[profile_ring_index][i];
+			p = &Profile_Stage[i];
+
+			if(ticks < p->min_ticks)
+			{
+				p->min_ticks = ticks;
+			}
+			if(ticks > p->max_ticks)
+			{
+				p->max_ticks = ticks;
+			}
+
+			// Rather than let the total wrap, halve the total and
+			// the count, which leaves the mean where it was.
+			if(p->total_ticks > 0xFFFFFFFF - (unsigned long)ticks)
+			{
+				p->total_ticks >>= 1;
+				p->count >>= 1;
+			}
+			p->total_ticks += ticks;
+			p->count++;
+		}
+	}
+	profile_stages_run = 0;
+
+	// move on to the next ring slot and clear it
+	profile_ring_index++;
+	profile_ring_index &= PROFILE_RING_INDEX_MASK;
+
+	for(i = 0; i < PROFILE_STAGE_COUNT; i++)
+	{
+		Profile_Ring[profile_ring_index][i] = 0;
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Profile_Reset()
+*
+*	PURPOSE:		Clears the per-stage statistics.
+*
+*	CALLED FROM:	Profile_Initialize_Timer() and Profile_Dump(), this file.
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The history ring is left alone.
+*
+*******************************************************************************/
+void Profile_Reset(void)
+{
+	unsigned char i;
+
+	for(i = 0; i < PROFILE_STAGE_COUNT; i++)
+	{
+		Profile_Stage[i].min_ticks = 0xFFFF;
+		Profile_Stage[i].max_ticks = 0;
+		Profile_Stage[i].total_ticks = 0;
+		Profile_Stage[i].count = 0;
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Profile_Frame_Byte()
+*
+*	PURPOSE:		Works out one byte of the profile frame.
+*
+*	CALLED FROM:	Profile_Dump_Send(), below.
+*
+*	PARAMETERS:		Offset of the byte in the frame, which must be less
+*					than PROFILE_FRAME_SIZE - 1.
+*
+*	RETURNS:		unsigned char
+*
+*	COMMENTS:		The frame is never built in RAM. Each byte is taken
+*					from the frozen statistics and ring as it is sent.
+*					16-bit values are sent high byte first.
+*
+*******************************************************************************/
+static unsigned char Profile_Frame_Byte(unsigned int offset)
+{
+	unsigned char stage;
+	unsigned char entry;
+	unsigned int word;
+	Profile_Stage_Type *p;
+
+	if(offset < PROFILE_FRAME_HEADER_SIZE)
+	{
+		switch((unsigned char)offset)
+		{
+			case 0:
+				return(PROFILE_FRAME_SYNC_1);
+			case 1:
+				return(PROFILE_FRAME_SYNC_2);
+			case 2:
+				return(PROFILE_STAGE_COUNT);
+			case 3:
+				return(PROFILE_TIMER_PRESCALE);
+			default:
+				return(PROFILE_RING_SIZE);
+		}
+	}
+
+	offset -= PROFILE_FRAME_HEADER_SIZE;
+
+	if(offset < PROFILE_FRAME_STAGES_SIZE)
+	{
+		// min, max and mean ticks for each stage; a stage that
+		// hasn't run since the last dump reports zero for all three
+		p = &Profile_Stage[offset / 6];
+
+		if(p->count == 0)
+		{
+			word = 0;
+		}
+		else
+		{
+			switch((unsigned char)((offset % 6) >> 1))
+			{
+				case 0:
+					word = p->min_ticks;
+					break;
+				case 1:
+					word = p->max_ticks;
+					break;
+				default:
+					word = (unsigned int)(p->total_ticks / p->count);
+					break;
+			}
+		}
+	}
+	else
+	{
+		// The whole ring, starting with the oldest entry, which is
+		// the one after the current slot, and ending with the
+		// current slot.
+		offset -= PROFILE_FRAME_STAGES_SIZE;
+		entry = (unsigned char)(offset / (PROFILE_STAGE_COUNT * 2));
+		stage = (unsigned char)((offset >> 1) % PROFILE_STAGE_COUNT);
+		entry = (profile_ring_index + entry + 1) & PROFILE_RING_INDEX_MASK;
+
+		word = Profile_Ring[entry][stage];
+	}
+
+	if((offset & 1) == 0)
+	{
+		return((unsigned char)(word >> 8));
+	}
+	return((unsigned char)word);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Profile_Dump_Send()
+*
+*	PURPOSE:		Sends the next part of the profile frame.
+*
+*	CALLED FROM:	Profile_End_Of_Loop(), above.
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Sends up to PROFILE_DUMP_BYTES_PER_LOOP bytes, stopping
+*					early if the terminal's transmit queue fills up. A byte
+*					the queue didn't take is sent again next time, so the
+*					frame always arrives whole. Once the checksum has gone
+*					out, the statistics are cleared and profiling resumes.
+*
+*******************************************************************************/
+static void Profile_Dump_Send(void)
+{
+	unsigned char i;
+	unsigned char byte;
+
+	for(i = 0; i < PROFILE_DUMP_BYTES_PER_LOOP; i++)
+	{
+		if(profile_dump_offset < PROFILE_FRAME_SIZE - 1)
+		{
+			byte = Profile_Frame_Byte(profile_dump_offset);
+		}
+		else
+		{
+			byte = profile_checksum;
+		}
+
+		if(Try_Write_Terminal_Serial_Port(byte) == 0)
+		{
+			return;
+		}
+
+		profile_checksum += byte;
+		profile_dump_offset++;
+
+		if(profile_dump_offset >= PROFILE_FRAME_SIZE)
+		{
+			// done, so start over with a clean slate
+			profile_dump_active = 0;
+			profile_stages_run = 0;
+			for(i = 0; i < PROFILE_STAGE_COUNT; i++)
+			{
+				Profile_Ring[profile_ring_index][i] = 0;
+			}
+			Profile_Reset();
+			return;
+		}
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Profile_Dump()
+*
+*	PURPOSE:		Starts sending the profile statistics to the terminal
+*					serial port as a binary frame.
+*
+*	CALLED FROM:	user_routines.c/Process_Data_From_Master_uP()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The frame layout is described at the top of this file.
+*					The frame is sent by Profile_End_Of_Loop() over the
+*					next few slow loops, and the statistics are cleared
+*					once it has all gone. Asking for another dump while
+*					one is being sent does nothing.
+*
+*******************************************************************************/
+void Profile_Dump(void)
+{
+	if(profile_dump_active == 1)
+	{
+		return;
+	}
+
+	profile_dump_active = 1;
+	profile_dump_offset = 0;
+	profile_checksum = 0;
+}
+
+#endif
@@ -0,0 +1,105 @@
+/*******************************************************************************
+*
+*	TITLE:		profile.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Slow loop cycle budget profiler. See profile.c for details.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+// comment out the next line to remove the per-stage instrumentation
+// from Process_Data_From_Master_uP(). The cycle timer itself is always
+// available.
+#define ENABLE_PROFILING
+
+// Timer3 is run from the instruction clock through this prescaler.
+// With a prescale of eight one timer tick is eight instruction cycles
+// and the timer wraps after 524,288 instruction cycles, or about 52ms,
+// which is twice the length of a slow loop.
+#define PROFILE_TIMER_PRESCALE 8
+
+// Number of slow loops kept in the per-stage history ring. This
+// value must be a power of two (i.e., 2, 4, 8, 16) for the circular
+// queue algorithm to function correctly.
+#define PROFILE_RING_SIZE 8
+#define PROFILE_RING_INDEX_MASK (PROFILE_RING_SIZE-1)
+
+// Sending this character from the terminal dumps the profile
+// (it's a control-P).
+#define PROFILE_DUMP_KEY 0x10
+
+// first two bytes of every binary profile frame
+#define PROFILE_FRAME_SYNC_1 0xFF
+#define PROFILE_FRAME_SYNC_2 'P'
+
+// Most bytes of a profile frame sent per slow loop. This must be
+// smaller than the terminal's transmit queue, which the serial
+// port empties between slow loops, so that sending never waits.
+#define PROFILE_DUMP_BYTES_PER_LOOP 24
+
+// stages of Process_Data_From_Master_uP() that are timed
+#define PROFILE_GETDATA			0
+#define PROFILE_CAMERA_HANDLER	1
+#define PROFILE_SERVO_TRACK		2
+#define PROFILE_TERMINAL		3
+#define PROFILE_EEPROM			4
+#define PROFILE_HOOD			5
+#define PROFILE_PUTDATA			6
+#define PROFILE_STAGE_COUNT		7
+
+// layout of a profile frame (see profile.c)
+#define PROFILE_FRAME_HEADER_SIZE	5
+#define PROFILE_FRAME_STAGES_SIZE	(PROFILE_STAGE_COUNT * 6)
+#define PROFILE_FRAME_RING_SIZE		(PROFILE_RING_SIZE * PROFILE_STAGE_COUNT * 2)
+#define PROFILE_FRAME_SIZE			(PROFILE_FRAME_HEADER_SIZE + PROFILE_FRAME_STAGES_SIZE + PROFILE_FRAME_RING_SIZE + 1)
+
+// per-stage statistics, in timer ticks
+typedef struct
+{
+	unsigned int min_ticks;		// cheapest pass through the stage
+	unsigned int max_ticks;		// most expensive pass through the stage
+	unsigned long total_ticks;	// sum of all passes, for the mean
+	unsigned long count;		// number of passes
+}	Profile_Stage_Type;
+
+#ifdef ENABLE_PROFILING
+#define PROFILE_START(stage) Profile_Start(stage)
+#define PROFILE_STOP(stage) Profile_Stop(stage)
+#define PROFILE_END_OF_LOOP() Profile_End_Of_Loop()
+#else
+#define PROFILE_START(stage)
+#define PROFILE_STOP(stage)
+#define PROFILE_END_OF_LOOP()
+#endif
+
+// global variables
+#ifdef ENABLE_PROFILING
+extern Profile_Stage_Type Profile_Stage[PROFILE_STAGE_COUNT];
+extern unsigned int Profile_Ring[PROFILE_RING_SIZE][PROFILE_STAGE_COUNT];
+#endif
+
+// function prototypes
+void Profile_Initialize_Timer(void);
+unsigned int Profile_Read_Timer(void);
+#ifdef ENABLE_PROFILING
+void Profile_Start(unsigned char);
+void Profile_Stop(unsigned char);
+void Profile_End_Of_Loop(void);
+void Profile_Reset(void);
+void Profile_Dump(void);
+#endif
+
+#endif
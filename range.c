@@ -0,0 +1,231 @@
+/*******************************************************************************
+*
+*	TITLE:		range.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	This file estimates the range to the target, in inches,
+*				once per slow loop from the newest camera T packet and
+*				the tilt servo command the packet was taken at.
+*
+*				Two estimates are made, both by table lookup. The first
+*				comes from the elevation angle of the target center,
+*				which is the tilt servo angle plus the angle of the
+*				bounding box center above the tracking row. The second
+*				comes from the height of the bounding box. When the box
+*				is clipped by the edge of the image or is too small to
+*				measure, only the elevation estimate is used.
+*				Otherwise the two are blended (see RANGE_BOX_WEIGHT in
+*				range.h).
+*
+*				The tables hold range in inches and were generated
+*				offline with the values listed in range.h:
+*
+*				Range_Elevation_Table[e] = 86 / tan(e / 4 degrees)
+*				Range_Box_Table[h] = 6 * 392 / h
+*
+*				Range_Estimate is RANGE_UNKNOWN and range_valid is zero
+*				when the camera has no target or its data is stale.
+*
+*				The shot decision (see Range_In_Shot_Window()) and the
+*				hood angle (see hood.c) are both taken from the
+*				estimate.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include "ifi_default.h"
+#include "camera.h"
+#include "tracking.h"
+#include "range.h"
+
+// range, in inches, indexed by elevation in quarter degrees
+rom const unsigned int Range_Elevation_Table[RANGE_ELEVATION_STEPS] =
+{
+	65535, 19710,  9855,  6570,  4927,  3941,  3284,  2815,  2463,  2189,
+	 1970,  1790,  1641,  1515,  1406,  1312,  1230,  1157,  1093,  1035,
+	  983,   936,   893,   854,   818,   785,   755,   727,   700,   676,
+	  653,   632,   612,   593,   575,   559,   543,   528,   514,   500,
+	  488,   476,   464,   453,   442,   432,   423,   413,   405,   396,
+	  388,   380,   373,   365,   358,   351,   345,   339,   333,   327,
+	  321,   315,   310,   305,   300,   295,   290,   286,   281,   277,
+	  273,   269,   265,   261,   257,   253,   250,   246,   243,   240,
+	  236,   233,   230,   227,   224,   221,   218,   216,   213,   210,
+	  208,   205,   203,   200,   198,   195,   193,   191,   189,   187,
+	  184,   182,   180,   178,   176,   174,   172,   171,   169,   167,
+	  165,   163,   162,   160,   158,   157,   155,   154,   152,   150,
+	  149,   147,   146,   145,   143,   142,   140,   139,   138,   136,
+	  135,   134,   132,   131,   130,   129,   128,   126,   125,   124,
+	  123,   122,   121,   119,   118,   117,   116,   115,   114,   113,
+	  112,   111,   110,   109,   108,   107,   106,   105,   104,   103,
+	  102,   102,   101,   100,    99,    98,    97,    96,    96,    95,
+	   94,    93,    92,    91,    91,    90,    89,    88,    88,    87,
+	   86,    85,    85,    84,    83,    82,    82,    81,    80,    79,
+	   79,    78,    77,    77,    76,    75,    75,    74,    73,    73,
+	   72,    72,    71,    70,    70,    69,    68,    68,    67,    67,
+	   66,    65,    65,    64,    64,    63,    62,    62,    61,    61,
+	   60,    60,    59,    59,    58,    57,    57,    56,    56,    55,
+	   55,    54,    54,    53,    53,    52,    52,    51,    51,    50,
+	   50,    49,    49,    48,    48,    47,    47,    46,    46,    45,
+	   45,    44,    44,    43,    43,    42
+};
+
+// range, in inches, indexed by bounding box height in image rows
+rom const unsigned int Range_Box_Table[RANGE_BOX_HEIGHT_STEPS] =
+{
+	65535,  2352,  1176,   784,   588,   470,   392,   336,   294,   261,
+	  235,   214,   196,   181,   168,   157,   147,   138,   131,   124,
+	  118,   112,   107,   102,    98,    94,    90,    87,    84,    81,
+	   78,    76,    74,    71,    69,    67,    65,    64,    62,    60,
+	   59,    57,    56,    55,    53,    52,    51,    50,    49,    48,
+	   47,    46,    45,    44,    44,    43,    42,    41,    41,    40,
+	   39,    39,    38,    37,    37,    36,    36,    35,    35,    34,
+	   34,    33,    33,    32,    32,    31,    31,    31,    30,    30,
+	   29,    29,    29,    28,    28,    28,    27,    27,    27,    26,
+	   26,    26,    26,    25,    25,    25,    24,    24,    24,    24,
+	   24,    23,    23,    23,    23,    22,    22,    22,    22,    22,
+	   21,    21,    21,    21,    21,    20,    20,    20,    20,    20,
+	   20,    19,    19,    19,    19,    19,    19,    19
+};
+
+// latest range estimate in inches
+unsigned int Range_Estimate = RANGE_UNKNOWN;
+
+// one if Range_Estimate is current
+unsigned char range_valid = 0;
+
+/*******************************************************************************
+*
+*	FUNCTION:		Range_Update()
+*
+*	PURPOSE:		Updates Range_Estimate from the newest T packet.
+*
+*	CALLED FROM:	tracking.c/Servo_Track()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The tilt servo command is taken from the T packet
+*					history entry, so the estimate isn't thrown off by
+*					tilt servo moves made after the packet arrived.
+*
+*******************************************************************************/
+void Range_Update(void)
+{
+	static unsigned char old_loop = 0;
+	T_Packet_History_Type entry;
+	int elevation;
+	unsigned char box_height;
+	unsigned int elevation_range;
+	unsigned int box_range;
+
+	// get the newest T packet and the servo commands it was taken at
+	if(Camera_Get_Packet_History(0, &entry) == 0)
+	{
+		// the entry was overwritten while being copied, so
+		// keep the last estimate and try again next loop
+		return;
+	}
+
+	// does the camera have a target, and is the packet recent?
+	if(entry.packet.my == 0 || (unsigned char)(camera_loop_count - entry.loop) > RANGE_MAX_AGE)
+	{
+		Range_Estimate = RANGE_UNKNOWN;
+		range_valid = 0;
+		return;
+	}
+
+	// nothing more to do if this packet has already been used
+	if(range_valid == 1 && entry.loop == old_loop)
+	{
+		return;
+	}
+	old_loop = entry.loop;
+
+	// elevation of the camera, in quarter degrees. The tracking
+	// code tilts the camera down when the tilt command moves in
+	// the direction of Tilt_Rotation_Sign.
+	elevation = -1 * (int)Tracking_Config_Data.Tilt_Rotation_Sign *
+		((int)entry.tilt_pwm - (int)Tracking_Config_Data.Tilt_Center_PWM) * RANGE_TILT_SCALE / 16;
+
+	// plus the elevation of the bounding box center within the image
+	elevation += ((int)Tracking_Config_Data.Tilt_Target_Pixel -
+		((int)entry.packet.y1 + (int)entry.packet.y2) / 2) * RANGE_ROW_SCALE / 16;
+
+	// a target at or below the horizon can't be ranged
+	if(elevation <= 0)
+	{
+		Range_Estimate = RANGE_UNKNOWN;
+		range_valid = 0;
+		return;
+	}
+	else if(elevation >= RANGE_ELEVATION_STEPS)
+	{
+		elevation = RANGE_ELEVATION_STEPS - 1;
+	}
+
+	elevation_range = Range_Elevation_Table[elevation];
+
+	// use the bounding box too if all of it is in the image
+	// and it's large enough to measure
+	box_height = entry.packet.y2 - entry.packet.y1;
+
+	if(entry.packet.x1 > 0 && entry.packet.x2 < IMAGE_WIDTH &&
+	   entry.packet.y1 > 0 && entry.packet.y2 < IMAGE_HEIGHT &&
+	   box_height >= RANGE_MIN_BOX_HEIGHT && entry.packet.pixels >= RANGE_MIN_PIXELS)
+	{
+		if(box_height >= RANGE_BOX_HEIGHT_STEPS)
+		{
+			box_height = RANGE_BOX_HEIGHT_STEPS - 1;
+		}
+
+		box_range = Range_Box_Table[box_height];
+
+		Range_Estimate = (unsigned int)(((long)elevation_range * (16 - RANGE_BOX_WEIGHT) +
+			(long)box_range * RANGE_BOX_WEIGHT) / 16);
+	}
+	else
+	{
+		Range_Estimate = elevation_range;
+	}
+
+	range_valid = 1;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Range_In_Shot_Window()
+*
+*	PURPOSE:		Tells whether the target is within shooting range.
+*
+*	CALLED FROM:	tracking.c/Tracking_Shot_Ready()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		1 if Range_Estimate is current and between
+*					RANGE_SHOT_MIN and RANGE_SHOT_MAX, 0 otherwise.
+*
+*	COMMENTS:		Call Range_Update() first.
+*
+*******************************************************************************/
+unsigned char Range_In_Shot_Window(void)
+{
+	if(range_valid == 1 &&
+	   Range_Estimate >= RANGE_SHOT_MIN && Range_Estimate <= RANGE_SHOT_MAX)
+	{
+		return(1);
+	}
+	else
+	{
+		return(0);
+	}
+}
@@ -0,0 +1,78 @@
+/*******************************************************************************
+*
+*	TITLE:		range.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Target range estimation. See range.c for details.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _RANGE_H
+#define _RANGE_H
+
+// The range tables in range.c were generated with these values.
+// If any of them change, the tables must be regenerated.
+//
+//	target center height above the camera lens:	86 inches
+//	height of the lit target:					6 inches
+//	camera focal length:						392 image rows
+//												(34 degree vertical
+//												field of view)
+
+// Elevation angles are kept in quarter degrees. These convert tilt
+// servo counts and image rows to quarter degrees (value / 16).
+//
+// RANGE_ROW_SCALE follows from the camera's field of view.
+// RANGE_TILT_SCALE follows from the tilt limits in tracking.h, which
+// are 25 degrees either side of Tilt_Center_PWM, and Range_Update()
+// takes Tilt_Center_PWM to be level. Check both if the camera mount
+// changes.
+#define RANGE_TILT_SCALE 53		// 0.83 degrees per tilt servo count
+#define RANGE_ROW_SCALE 9		// 0.14 degrees per image row
+
+// number of entries in the range tables
+#define RANGE_ELEVATION_STEPS 256	// zero to 63.75 degrees
+#define RANGE_BOX_HEIGHT_STEPS 128	// zero to 127 image rows
+
+// The bounding box estimate is only used when the box is at least
+// this many rows tall and the camera reports at least this many
+// tracked pixels. Smaller boxes are too coarse to be useful.
+#define RANGE_MIN_BOX_HEIGHT 4
+#define RANGE_MIN_PIXELS 8
+
+// Share of the bounding box estimate, in sixteenths, when both
+// estimates are available. The rest comes from the elevation estimate.
+#define RANGE_BOX_WEIGHT 4
+
+// The estimate is marked invalid when the newest T packet is older
+// than this many slow loops.
+#define RANGE_MAX_AGE 4
+
+// Range_Estimate value when no estimate is available
+#define RANGE_UNKNOWN 0xFFFF
+
+// Ranges, in inches, the shooter can score from. Tracking_Shot_Ready()
+// only reports a shot when Range_Estimate is within them. The hood
+// calibration table in hood.c covers the same ranges.
+#define RANGE_SHOT_MIN 120
+#define RANGE_SHOT_MAX 240
+
+// global variables
+extern unsigned int Range_Estimate;
+extern unsigned char range_valid;
+
+// function prototypes
+void Range_Update(void);
+unsigned char Range_In_Shot_Window(void);
+
+#endif
@@ -151,18 +151,27 @@
 #include <p18f8722.h>
 #include <stdio.h>
 #include "serial_ports.h"
+#include "camera.h"
 
 // by default stdout stream output is sent to the null device, 
 // which is the only device guaranteed to be present. 
 unsigned char stdout_serial_port = NUL;
 
+#ifdef ENABLE_SERIAL_PORT_STATS
+// per-port statistics returned by Serial_Get_Stats()
+Serial_Port_Stats_Type Serial_Port_One_Stats = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+Serial_Port_Stats_Type Serial_Port_Two_Stats = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+#endif
+
 //
 // Serial Port 1 Receive Variables:
 //
 
 #ifdef ENABLE_SERIAL_PORT_ONE_RX
 
+#pragma udata SERIAL_QUEUES
 volatile unsigned char Rx_1_Queue[RX_1_QUEUE_SIZE];	// serial port 1's receive circular queue
+#pragma udata
 
 volatile unsigned char Rx_1_Queue_Full = FALSE;		// flag that indicates that serial port 1's
 													// receive circular queue is full and cannot
@@ -172,14 +181,14 @@ unsigned char Rx_1_Queue_Empty = TRUE;				// flag that indicates that there is n
 													// data present in serial port 1's receive
 													// circular queue
 
-unsigned char Rx_1_Queue_Read_Index = 0;			// read index into serial port 1's receive
+Rx_1_Queue_Index_Type Rx_1_Queue_Read_Index = 0;	// read index into serial port 1's receive
 													// circular queue
 	
-volatile unsigned char Rx_1_Queue_Write_Index = 0;	// write index into serial port 1's receive
-													// circular queue
+volatile Rx_1_Queue_Index_Type Rx_1_Queue_Write_Index = 0;	// write index into serial port 1's receive
+															// circular queue
 	
-volatile unsigned char Rx_1_Queue_Byte_Count = 0;	// number of bytes in serial port 1's receive
-													// circular queue
+volatile Rx_1_Queue_Index_Type Rx_1_Queue_Byte_Count = 0;	// number of bytes in serial port 1's receive
+															// circular queue
 
 volatile unsigned char RX_1_Overrun_Errors = 0;		// number of overrun errors that have occurred
 													// in serial port 1's receive circuitry since
@@ -196,7 +205,9 @@ volatile unsigned char RX_1_Framing_Errors = 0;		// number of framing errors tha
 
 #ifdef ENABLE_SERIAL_PORT_ONE_TX
 
+#pragma udata SERIAL_QUEUES
 volatile unsigned char Tx_1_Queue[TX_1_QUEUE_SIZE];	// serial port 1's transmit circular queue
+#pragma udata
 
 volatile unsigned char Tx_1_Queue_Full = FALSE;		// flag that indicates that serial port 1's
 													// transmit circular queue is full and cannot
@@ -206,14 +217,18 @@ volatile unsigned char Tx_1_Queue_Empty = TRUE;		// flag that indicates that the
 													// data to send in serial port 1's transmit
 													// circular queue
 
-volatile unsigned char Tx_1_Queue_Read_Index = 0;	// read index into serial port 1's transmit
-													// circular queue
+volatile Tx_1_Queue_Index_Type Tx_1_Queue_Read_Index = 0;	// read index into serial port 1's transmit
+															// circular queue
 
-unsigned char Tx_1_Queue_Write_Index = 0;			// write index into serial port 1's transmit
+Tx_1_Queue_Index_Type Tx_1_Queue_Write_Index = 0;	// write index into serial port 1's transmit
 													// circular queue
 
-volatile unsigned char Tx_1_Queue_Byte_Count = 0;	// number of bytes in serial port 1's transmit
-													// circular queue
+volatile Tx_1_Queue_Index_Type Tx_1_Queue_Byte_Count = 0;	// number of bytes in serial port 1's transmit
+															// circular queue
+
+unsigned char Tx_1_Queue_Full_Policy = TX_1_FULL_POLICY;	// what Write_Serial_Port_xxx() does
+															// when serial port 1's transmit
+															// circular queue is full
 #endif
 
 //
@@ -222,7 +237,9 @@ volatile unsigned char Tx_1_Queue_Byte_Count = 0;	// number of bytes in serial p
 
 #ifdef ENABLE_SERIAL_PORT_TWO_RX
 
+#pragma udata SERIAL_QUEUES
 volatile unsigned char Rx_2_Queue[RX_2_QUEUE_SIZE];	// serial port 2's receive circular queue
+#pragma udata
 
 volatile unsigned char Rx_2_Queue_Full = FALSE;		// flag that indicates that serial port 2's
 													// receive circular queue is full and cannot
@@ -232,14 +249,14 @@ unsigned char Rx_2_Queue_Empty = TRUE;				// flag that indicates that there is n
 													// data present in serial port 2's receive
 													// circular queue
 		
-unsigned char Rx_2_Queue_Read_Index = 0;			// read index into serial port 2's receive
+Rx_2_Queue_Index_Type Rx_2_Queue_Read_Index = 0;	// read index into serial port 2's receive
 													// circular queue
 
-volatile unsigned char Rx_2_Queue_Write_Index = 0;	// write index into serial port 2's receive
-													// circular queue
+volatile Rx_2_Queue_Index_Type Rx_2_Queue_Write_Index = 0;	// write index into serial port 2's receive
+															// circular queue
 
-volatile unsigned char Rx_2_Queue_Byte_Count = 0;	// number of bytes in serial port 2's receive
-													// circular queue
+volatile Rx_2_Queue_Index_Type Rx_2_Queue_Byte_Count = 0;	// number of bytes in serial port 2's receive
+															// circular queue
 
 volatile unsigned char RX_2_Overrun_Errors = 0;		// number of overrun errors that have occurred
 													// in serial port 2's receive circuitry since
@@ -256,7 +273,9 @@ volatile unsigned char RX_2_Framing_Errors = 0;		// number of framing errors tha
 
 #ifdef ENABLE_SERIAL_PORT_TWO_TX
 
+#pragma udata SERIAL_QUEUES
 volatile unsigned char Tx_2_Queue[TX_2_QUEUE_SIZE];	// serial port 2's transmit circular queue
+#pragma udata
 
 volatile unsigned char Tx_2_Queue_Full = FALSE;		// flag that indicates that serial port 2's
 													// transmit circular queue is full and cannot
@@ -266,14 +285,18 @@ volatile unsigned char Tx_2_Queue_Empty = TRUE;		// flag that indicates that the
 													// data to send in serial port 2's transmit
 													// circular queue
 
-volatile unsigned char Tx_2_Queue_Read_Index = 0;	// read index into serial port 2's transmit
-													// circular queue
+volatile Tx_2_Queue_Index_Type Tx_2_Queue_Read_Index = 0;	// read index into serial port 2's transmit
+															// circular queue
 
-unsigned char Tx_2_Queue_Write_Index = 0;			// write index into serial port 2's transmit
+Tx_2_Queue_Index_Type Tx_2_Queue_Write_Index = 0;	// write index into serial port 2's transmit
 													// circular queue
 
-volatile unsigned char Tx_2_Queue_Byte_Count = 0;	// number of bytes in serial port 2's transmit
-													// circular queue
+volatile Tx_2_Queue_Index_Type Tx_2_Queue_Byte_Count = 0;	// number of bytes in serial port 2's transmit
+															// circular queue
+
+unsigned char Tx_2_Queue_Full_Policy = TX_2_FULL_POLICY;	// what Write_Serial_Port_xxx() does
+															// when serial port 2's transmit
+															// circular queue is full
 #endif
 
 /*******************************************************************************
@@ -553,7 +576,7 @@ void Init_Serial_Port_Two(void)
 *
 *	PARAMETERS:		none
 *
-*	RETURNS:		unsigned char
+*	RETURNS:		Rx_1_Queue_Index_Type
 *
 *	COMMENTS:		This function must be called to determine how much data,
 *					if any, is present in serial port one's received data
@@ -566,9 +589,9 @@ void Init_Serial_Port_Two(void)
 *
 *******************************************************************************/
 #ifdef ENABLE_SERIAL_PORT_ONE_RX
-unsigned char Serial_Port_One_Byte_Count(void)
+Rx_1_Queue_Index_Type Serial_Port_One_Byte_Count(void)
 {
-	unsigned char temp;
+	Rx_1_Queue_Index_Type temp;
 
 	// since we're about to use the Rx_1_Queue_Byte_Count variable,
 	// which can also be modified in the interrupt service routine,
@@ -601,7 +624,7 @@ unsigned char Serial_Port_One_Byte_Count(void)
 *
 *	PARAMETERS:		none
 *
-*	RETURNS:		unsigned char
+*	RETURNS:		Rx_2_Queue_Index_Type
 *
 *	COMMENTS:		This function must be called to determine how much data,
 *					if any, is present in serial port two's received data
@@ -614,9 +637,9 @@ unsigned char Serial_Port_One_Byte_Count(void)
 *
 *******************************************************************************/
 #ifdef ENABLE_SERIAL_PORT_TWO_RX
-unsigned char Serial_Port_Two_Byte_Count(void)
+Rx_2_Queue_Index_Type Serial_Port_Two_Byte_Count(void)
 {
-	unsigned char temp;
+	Rx_2_Queue_Index_Type temp;
 
 	// since we're about to use the Rx_1_Queue_Byte_Count variable,
 	// which can also be modified in the interrupt service routine,
@@ -669,6 +692,12 @@ unsigned char Read_Serial_Port_One(void)
 		// get a byte from the circular queue and store it temporarily
 		byte = Rx_1_Queue[Rx_1_Queue_Read_Index];
 
+		// since we're about to use the queue indices and byte count, which are also
+		// used in the interrupt service routine and may be wider than eight bits (see
+		// serial_ports.h), let's briefly disable the serial port interrupt to make
+		// sure that they don't get altered or seen half-updated while we're using them.
+		PIE1bits.RC1IE = 0;
+
 		// decrement the queue byte count
 		Rx_1_Queue_Byte_Count--;
 
@@ -681,19 +710,13 @@ unsigned char Read_Serial_Port_One(void)
 		// to work, the queue size must be a power of 2 (e.g., 16,32,64,128...).
 		Rx_1_Queue_Read_Index &= RX_1_QUEUE_INDEX_MASK;
 
-		// since we're about to use the Rx_1_Queue_Write_Index variable, which can
-		// also be modified in the interrupt service routine, let's briefly disable
-		// the serial port interrupt to make sure that Rx_1_Queue_Write_Index doesn't 
-		// get altered while we're using it.
-		PIE1bits.RC1IE = 0;
-
 		// is the circular queue now empty?
 		if(Rx_1_Queue_Read_Index == Rx_1_Queue_Write_Index)
 		{
 			Rx_1_Queue_Empty = TRUE;
 		}
 
-		// okay, we're done using Rx_1_Queue_Write_Index, so turn the serial port
+		// okay, we're done using the queue state, so turn the serial port
 		// interrupt back on.
 		PIE1bits.RC1IE = 1;
 
@@ -738,6 +761,12 @@ unsigned char Read_Serial_Port_Two(void)
 		// get a byte from the circular queue and store it temporarily
 		byte = Rx_2_Queue[Rx_2_Queue_Read_Index];
 
+		// since we're about to use the queue indices and byte count, which are also
+		// used in the interrupt service routine and may be wider than eight bits (see
+		// serial_ports.h), let's briefly disable the serial port interrupt to make
+		// sure that they don't get altered or seen half-updated while we're using them.
+		PIE3bits.RC2IE = 0;
+
 		// decrement the queue byte count
 		Rx_2_Queue_Byte_Count--;
 
@@ -750,19 +779,13 @@ unsigned char Read_Serial_Port_Two(void)
 		// to work, the queue size must be a power of 2 (e.g., 16,32,64,128...).
 		Rx_2_Queue_Read_Index &= RX_2_QUEUE_INDEX_MASK;
 
-		// since we're about to use the Rx_2_Queue_Write_Index variable, which can
-		// also be modified in the interrupt service routine, let's briefly disable
-		// the serial port interrupt to make sure that Rx_2_Queue_Write_Index doesn't 
-		// get altered while we're using it.
-		PIE3bits.RC2IE = 0;
-
 		// is the circular queue now empty?
 		if(Rx_2_Queue_Read_Index == Rx_2_Queue_Write_Index)
 		{
 			Rx_2_Queue_Empty = TRUE;
 		}
 
-		// okay, we're done using Rx_2_Queue_Write_Index, so turn the serial port
+		// okay, we're done using the queue state, so turn the serial port
 		// interrupt back on.
 		PIE3bits.RC2IE = 1;
 
@@ -776,6 +799,126 @@ unsigned char Read_Serial_Port_Two(void)
 }
 #endif
 
+/*******************************************************************************
+*
+*	FUNCTION:		Release_Serial_Port_One()
+*
+*	PURPOSE:		Removes a block of bytes from serial port one's
+*					received data queue.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Number of bytes to remove.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		This is the bulk counterpart of Read_Serial_Port_One().
+*					Data is examined in place with PEEK_SERIAL_PORT_ONE()
+*					and then given back all at once, so the serial port
+*					interrupt is only disabled once no matter how many
+*					bytes were consumed.
+*
+*					The count must not be larger than the value last
+*					returned by Serial_Port_One_Byte_Count().
+*
+*					This function will not be included in the build unless
+*					ENABLE_SERIAL_PORT_ONE_RX is #define'd in serial_ports.h
+*
+*******************************************************************************/
+#ifdef ENABLE_SERIAL_PORT_ONE_RX
+void Release_Serial_Port_One(Rx_1_Queue_Index_Type count)
+{
+	if(count == 0)
+	{
+		return;
+	}
+
+	// The queue indices and byte count are also used in the interrupt
+	// service routine, so briefly disable the serial port interrupt
+	// while we update the queue state.
+	PIE1bits.RC1IE = 0;
+
+	// advance the read pointer past the consumed bytes. For this to work,
+	// the queue size must be a power of 2 (e.g., 16,32,64,128...).
+	Rx_1_Queue_Read_Index += count;
+	Rx_1_Queue_Read_Index &= RX_1_QUEUE_INDEX_MASK;
+
+	Rx_1_Queue_Byte_Count -= count;
+
+	// is the circular queue now empty?
+	if(Rx_1_Queue_Read_Index == Rx_1_Queue_Write_Index)
+	{
+		Rx_1_Queue_Empty = TRUE;
+	}
+
+	// Since we've just removed data from the queue, it can't possibly be full.
+	Rx_1_Queue_Full = FALSE;
+
+	// okay, we're done, so turn the serial port interrupt back on.
+	PIE1bits.RC1IE = 1;
+}
+#endif
+
+/*******************************************************************************
+*
+*	FUNCTION:		Release_Serial_Port_Two()
+*
+*	PURPOSE:		Removes a block of bytes from serial port two's
+*					received data queue.
+*
+*	CALLED FROM:	camera.c/Camera_Handler()
+*
+*	PARAMETERS:		Number of bytes to remove.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		This is the bulk counterpart of Read_Serial_Port_Two().
+*					Data is examined in place with PEEK_SERIAL_PORT_TWO()
+*					and then given back all at once, so the serial port
+*					interrupt is only disabled once no matter how many
+*					bytes were consumed.
+*
+*					The count must not be larger than the value last
+*					returned by Serial_Port_Two_Byte_Count().
+*
+*					This function will not be included in the build unless
+*					ENABLE_SERIAL_PORT_TWO_RX is #define'd in serial_ports.h
+*
+*******************************************************************************/
+#ifdef ENABLE_SERIAL_PORT_TWO_RX
+void Release_Serial_Port_Two(Rx_2_Queue_Index_Type count)
+{
+	if(count == 0)
+	{
+		return;
+	}
+
+	// The queue indices and byte count are also used in the interrupt
+	// service routine, so briefly disable the serial port interrupt
+	// while we update the queue state.
+	PIE3bits.RC2IE = 0;
+
+	// advance the read pointer past the consumed bytes. For this to work,
+	// the queue size must be a power of 2 (e.g., 16,32,64,128...).
+	Rx_2_Queue_Read_Index += count;
+	Rx_2_Queue_Read_Index &= RX_2_QUEUE_INDEX_MASK;
+
+	Rx_2_Queue_Byte_Count -= count;
+
+	// is the circular queue now empty?
+	if(Rx_2_Queue_Read_Index == Rx_2_Queue_Write_Index)
+	{
+		Rx_2_Queue_Empty = TRUE;
+	}
+
+	// Since we've just removed data from the queue, it can't possibly be full.
+	Rx_2_Queue_Full = FALSE;
+
+	// okay, we're done, so turn the serial port interrupt back on.
+	PIE3bits.RC2IE = 1;
+}
+#endif
+
 /*******************************************************************************
 *
 *	FUNCTION:		Write_Serial_Port_One()
@@ -803,15 +946,68 @@ unsigned char Read_Serial_Port_Two(void)
 #ifdef ENABLE_SERIAL_PORT_ONE_TX
 void Write_Serial_Port_One(unsigned char byte)
 {
-	// if the queue is full, wait here until space is available
-	while(Tx_1_Queue_Full);
+	// what we do when the queue is full depends upon the port's policy
+	if(Tx_1_Queue_Full)
+	{
+		if(Tx_1_Queue_Full_Policy == TX_DROP_NEWEST)
+		{
+			// throw away the byte we were asked to send
+			#ifdef ENABLE_SERIAL_PORT_STATS
+			Serial_Port_One_Stats.tx_dropped++;
+			#endif
+			return;
+		}
+		else if(Tx_1_Queue_Full_Policy == TX_DROP_OLDEST)
+		{
+			// make room by throwing away the oldest byte in the queue. The
+			// interrupt service routine may have sent it in the meantime, so
+			// check again with the serial port interrupt disabled.
+			PIE1bits.TX1IE = 0;
+
+			if(Tx_1_Queue_Full)
+			{
+				Tx_1_Queue_Read_Index++;
+				Tx_1_Queue_Read_Index &= TX_1_QUEUE_INDEX_MASK;
+				Tx_1_Queue_Byte_Count--;
+				Tx_1_Queue_Full = FALSE;
+
+				#ifdef ENABLE_SERIAL_PORT_STATS
+				Serial_Port_One_Stats.tx_dropped++;
+				#endif
+			}
+
+			PIE1bits.TX1IE = 1;
+		}
+		else
+		{
+			// wait here until space is available
+			#ifdef ENABLE_SERIAL_PORT_STATS
+			Serial_Port_One_Stats.tx_full_waits++;
+			#endif
+			while(Tx_1_Queue_Full);
+		}
+	}
 
 	// put the byte on the circular queue
 	Tx_1_Queue[Tx_1_Queue_Write_Index] = byte;
 
+	// since we're about to use the queue indices and byte count, which are also
+	// used in the interrupt service routine and may be wider than eight bits (see
+	// serial_ports.h), let's briefly disable the serial port interrupt to make
+	// sure that they don't get altered or seen half-updated while we're using them.
+	PIE1bits.TX1IE = 0;
+
 	// increment the queue byte count
 	Tx_1_Queue_Byte_Count++;
 
+	#ifdef ENABLE_SERIAL_PORT_STATS
+	Serial_Port_One_Stats.tx_bytes++;
+	if(Tx_1_Queue_Byte_Count > Serial_Port_One_Stats.tx_high_water)
+	{
+		Serial_Port_One_Stats.tx_high_water = Tx_1_Queue_Byte_Count;
+	}
+	#endif
+
 	// increment the write pointer
 	Tx_1_Queue_Write_Index++;
 
@@ -821,25 +1017,199 @@ void Write_Serial_Port_One(unsigned char byte)
 	// to work, the queue size must be a power of 2 (e.g., 16,32,64,128...).
 	Tx_1_Queue_Write_Index &= TX_1_QUEUE_INDEX_MASK;
 
-	// since we're about to use the Tx_1_Queue_Write_Index variable, which can
-	// also be modified in the interrupt service routine, let's briefly disable
-	// the serial port interrupt to make sure that Tx_1_Queue_Write_Index doesn't 
-	// get altered while we're using it.
-	PIE1bits.TX1IE = 0;
-
 	// is the circular queue now full?
 	if(Tx_1_Queue_Read_Index == Tx_1_Queue_Write_Index)
 	{ 
 		Tx_1_Queue_Full = TRUE;
 	}
 
-	// okay, we're done using Tx_Queue_Write_Index, so turn the serial port
+	// Since we've just added a byte to the queue, it can't possibly be empty.
+	// Again, this is quicker than using an if() statement every time. This
+	// must be done before the interrupt is turned back on, otherwise the
+	// interrupt service routine could see the queue as empty and turn
+	// itself off with our byte still in the queue.
+	Tx_1_Queue_Empty = FALSE;
+
+	// okay, we're done using the queue state, so turn the serial port
 	// interrupt back on.
 	PIE1bits.TX1IE = 1;
+}
+#endif
+
+/*******************************************************************************
+*
+*	FUNCTION:		Try_Write_Serial_Port_One()
+*
+*	PURPOSE:		Sends a byte of data using serial port one without
+*					ever waiting for room in the transmit queue.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		unsigned char
+*
+*	RETURNS:		Number of bytes accepted: 1 if the byte was queued, 0
+*					if the transmit queue was full.
+*
+*	COMMENTS:		If Tx_1_Queue_Full_Policy is TX_DROP_OLDEST, room is
+*					made by throwing away the oldest queued byte and the
+*					byte is always accepted. Otherwise, a full queue means
+*					the byte is thrown away, whatever the policy.
+*
+*					This function will not be included in the build unless
+*					ENABLE_SERIAL_PORT_ONE_TX is #define'd in serial_ports.h
+*
+*******************************************************************************/
+#ifdef ENABLE_SERIAL_PORT_ONE_TX
+unsigned char Try_Write_Serial_Port_One(unsigned char byte)
+{
+	// The queue can only go from full to not full behind our back, so
+	// if it isn't full now, Write_Serial_Port_One() won't wait.
+	if(Tx_1_Queue_Full && Tx_1_Queue_Full_Policy != TX_DROP_OLDEST)
+	{
+		#ifdef ENABLE_SERIAL_PORT_STATS
+		Serial_Port_One_Stats.tx_dropped++;
+		#endif
+		return(0);
+	}
+
+	Write_Serial_Port_One(byte);
+
+	return(1);
+}
+#endif
+
+/*******************************************************************************
+*
+*	FUNCTION:		Write_Serial_Port_One_Buffer()
+*
+*	PURPOSE:		Sends a block of data using serial port one.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Pointer to the data and number of bytes to send.
+*
+*	RETURNS:		Number of bytes accepted, which is either all of them
+*					or, if the data couldn't be queued, zero.
+*
+*	COMMENTS:		Room for the whole block is found before anything is
+*					queued, the bytes are copied in and then the queue
+*					state is updated with the serial port interrupt
+*					disabled just once, so the block is never half queued.
+*
+*					If there isn't enough room, Tx_1_Queue_Full_Policy
+*					decides what happens: TX_BLOCK waits for room,
+*					TX_DROP_NEWEST throws away the whole block and
+*					TX_DROP_OLDEST throws away as many of the oldest queued
+*					bytes as needed.
+*
+*					Blocks larger than TX_1_QUEUE_SIZE are never accepted.
+*
+*					This function will not be included in the build unless
+*					ENABLE_SERIAL_PORT_ONE_TX is #define'd in serial_ports.h
+*
+*******************************************************************************/
+#ifdef ENABLE_SERIAL_PORT_ONE_TX
+unsigned char Write_Serial_Port_One_Buffer(unsigned char *data, unsigned char count)
+{
+	Tx_1_Queue_Index_Type room;
+	Tx_1_Queue_Index_Type index;
+	unsigned char i;
+
+	if(count == 0 || count > TX_1_QUEUE_SIZE)
+	{
+		return(0);
+	}
+
+	// find out how much room there is. The interrupt service routine can
+	// only make more, so this is a safe lower bound.
+	PIE1bits.TX1IE = 0;
+	room = TX_1_QUEUE_SIZE - Tx_1_Queue_Byte_Count;
+	PIE1bits.TX1IE = 1;
+
+	if(room < count)
+	{
+		if(Tx_1_Queue_Full_Policy == TX_DROP_NEWEST)
+		{
+			// throw away the block we were asked to send
+			#ifdef ENABLE_SERIAL_PORT_STATS
+			Serial_Port_One_Stats.tx_dropped += count;
+			#endif
+			return(0);
+		}
+		else if(Tx_1_Queue_Full_Policy == TX_DROP_OLDEST)
+		{
+			// make room by throwing away the oldest bytes in the queue,
+			// taking into account any sent since we last looked
+			PIE1bits.TX1IE = 0;
+
+			room = TX_1_QUEUE_SIZE - Tx_1_Queue_Byte_Count;
+
+			if(room < count)
+			{
+				Tx_1_Queue_Read_Index += count - room;
+				Tx_1_Queue_Read_Index &= TX_1_QUEUE_INDEX_MASK;
+				Tx_1_Queue_Byte_Count -= count - room;
+				Tx_1_Queue_Full = FALSE;
+
+				#ifdef ENABLE_SERIAL_PORT_STATS
+				Serial_Port_One_Stats.tx_dropped += count - room;
+				#endif
+			}
+
+			PIE1bits.TX1IE = 1;
+		}
+		else
+		{
+			// wait here until enough space is available
+			#ifdef ENABLE_SERIAL_PORT_STATS
+			Serial_Port_One_Stats.tx_full_waits++;
+			#endif
+			while(room < count)
+			{
+				PIE1bits.TX1IE = 0;
+				room = TX_1_QUEUE_SIZE - Tx_1_Queue_Byte_Count;
+				PIE1bits.TX1IE = 1;
+			}
+		}
+	}
+
+	// copy the data into the free part of the queue. The interrupt service
+	// routine doesn't look past Tx_1_Queue_Write_Index, so this doesn't
+	// need to be protected.
+	index = Tx_1_Queue_Write_Index;
+	for(i = 0; i < count; i++)
+	{
+		Tx_1_Queue[index] = data[i];
+		index++;
+		index &= TX_1_QUEUE_INDEX_MASK;
+	}
+
+	// now publish the whole block in one shot
+	PIE1bits.TX1IE = 0;
+
+	Tx_1_Queue_Write_Index = index;
+	Tx_1_Queue_Byte_Count += count;
+
+	#ifdef ENABLE_SERIAL_PORT_STATS
+	Serial_Port_One_Stats.tx_bytes += count;
+	if(Tx_1_Queue_Byte_Count > Serial_Port_One_Stats.tx_high_water)
+	{
+		Serial_Port_One_Stats.tx_high_water = Tx_1_Queue_Byte_Count;
+	}
+	#endif
+
+	// is the circular queue now full?
+	if(Tx_1_Queue_Read_Index == Tx_1_Queue_Write_Index)
+	{ 
+		Tx_1_Queue_Full = TRUE;
+	}
 
-	// Since we've just added a byte to the queue, it can't possibly be empty.
-	// Again, this is quicker than using an if() statement every time
 	Tx_1_Queue_Empty = FALSE;
+
+	// turning the interrupt back on starts the transmitter if it was idle
+	PIE1bits.TX1IE = 1;
+
+	return(count);
 }
 #endif
 
@@ -870,15 +1240,68 @@ void Write_Serial_Port_One(unsigned char byte)
 #ifdef ENABLE_SERIAL_PORT_TWO_TX
 void Write_Serial_Port_Two(unsigned char byte)
 {
-	// if the queue is full, wait here until space is available
-	while(Tx_2_Queue_Full);
+	// what we do when the queue is full depends upon the port's policy
+	if(Tx_2_Queue_Full)
+	{
+		if(Tx_2_Queue_Full_Policy == TX_DROP_NEWEST)
+		{
+			// throw away the byte we were asked to send
+			#ifdef ENABLE_SERIAL_PORT_STATS
+			Serial_Port_Two_Stats.tx_dropped++;
+			#endif
+			return;
+		}
+		else if(Tx_2_Queue_Full_Policy == TX_DROP_OLDEST)
+		{
+			// make room by throwing away the oldest byte in the queue. The
+			// interrupt service routine may have sent it in the meantime, so
+			// check again with the serial port interrupt disabled.
+			PIE3bits.TX2IE = 0;
+
+			if(Tx_2_Queue_Full)
+			{
+				Tx_2_Queue_Read_Index++;
+				Tx_2_Queue_Read_Index &= TX_2_QUEUE_INDEX_MASK;
+				Tx_2_Queue_Byte_Count--;
+				Tx_2_Queue_Full = FALSE;
+
+				#ifdef ENABLE_SERIAL_PORT_STATS
+				Serial_Port_Two_Stats.tx_dropped++;
+				#endif
+			}
+
+			PIE3bits.TX2IE = 1;
+		}
+		else
+		{
+			// wait here until space is available
+			#ifdef ENABLE_SERIAL_PORT_STATS
+			Serial_Port_Two_Stats.tx_full_waits++;
+			#endif
+			while(Tx_2_Queue_Full);
+		}
+	}
 
 	// put the byte on the circular queue
 	Tx_2_Queue[Tx_2_Queue_Write_Index] = byte;
 
+	// since we're about to use the queue indices and byte count, which are also
+	// used in the interrupt service routine and may be wider than eight bits (see
+	// serial_ports.h), let's briefly disable the serial port interrupt to make
+	// sure that they don't get altered or seen half-updated while we're using them.
+	PIE3bits.TX2IE = 0;
+
 	// increment the queue byte count
 	Tx_2_Queue_Byte_Count++;
 
+	#ifdef ENABLE_SERIAL_PORT_STATS
+	Serial_Port_Two_Stats.tx_bytes++;
+	if(Tx_2_Queue_Byte_Count > Serial_Port_Two_Stats.tx_high_water)
+	{
+		Serial_Port_Two_Stats.tx_high_water = Tx_2_Queue_Byte_Count;
+	}
+	#endif
+
 	// increment the write pointer
 	Tx_2_Queue_Write_Index++;
 
@@ -888,25 +1311,199 @@ void Write_Serial_Port_Two(unsigned char byte)
 	// to work, the queue size must be a power of 2 (e.g., 16,32,64,128...).
 	Tx_2_Queue_Write_Index &= TX_2_QUEUE_INDEX_MASK;
 
-	// since we're about to use the Tx_2_Queue_Write_Index variable, which can
-	// also be modified in the interrupt service routine, let's briefly disable
-	// the serial port interrupt to make sure that Tx_2_Queue_Write_Index doesn't 
-	// get altered while we're using it.
-	PIE3bits.TX2IE = 0;
-
 	// is the circular queue now full?
 	if(Tx_2_Queue_Read_Index == Tx_2_Queue_Write_Index)
 	{ 
 		Tx_2_Queue_Full = TRUE;
 	}
 
-	// okay, we're done using Tx_2_Queue_Write_Index, so turn the serial port
+	// Since we've just added a byte to the queue, it can't possibly be empty.
+	// Again, this is quicker than using an if() statement every time. This
+	// must be done before the interrupt is turned back on, otherwise the
+	// interrupt service routine could see the queue as empty and turn
+	// itself off with our byte still in the queue.
+	Tx_2_Queue_Empty = FALSE;
+
+	// okay, we're done using the queue state, so turn the serial port
 	// interrupt back on.
 	PIE3bits.TX2IE = 1;
+}
+#endif
+
+/*******************************************************************************
+*
+*	FUNCTION:		Try_Write_Serial_Port_Two()
+*
+*	PURPOSE:		Sends a byte of data using serial port two without
+*					ever waiting for room in the transmit queue.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		unsigned char
+*
+*	RETURNS:		Number of bytes accepted: 1 if the byte was queued, 0
+*					if the transmit queue was full.
+*
+*	COMMENTS:		If Tx_2_Queue_Full_Policy is TX_DROP_OLDEST, room is
+*					made by throwing away the oldest queued byte and the
+*					byte is always accepted. Otherwise, a full queue means
+*					the byte is thrown away, whatever the policy.
+*
+*					This function will not be included in the build unless
+*					ENABLE_SERIAL_PORT_TWO_TX is #define'd in serial_ports.h
+*
+*******************************************************************************/
+#ifdef ENABLE_SERIAL_PORT_TWO_TX
+unsigned char Try_Write_Serial_Port_Two(unsigned char byte)
+{
+	// The queue can only go from full to not full behind our back, so
+	// if it isn't full now, Write_Serial_Port_Two() won't wait.
+	if(Tx_2_Queue_Full && Tx_2_Queue_Full_Policy != TX_DROP_OLDEST)
+	{
+		#ifdef ENABLE_SERIAL_PORT_STATS
+		Serial_Port_Two_Stats.tx_dropped++;
+		#endif
+		return(0);
+	}
+
+	Write_Serial_Port_Two(byte);
+
+	return(1);
+}
+#endif
+
+/*******************************************************************************
+*
+*	FUNCTION:		Write_Serial_Port_Two_Buffer()
+*
+*	PURPOSE:		Sends a block of data using serial port two.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Pointer to the data and number of bytes to send.
+*
+*	RETURNS:		Number of bytes accepted, which is either all of them
+*					or, if the data couldn't be queued, zero.
+*
+*	COMMENTS:		Room for the whole block is found before anything is
+*					queued, the bytes are copied in and then the queue
+*					state is updated with the serial port interrupt
+*					disabled just once, so the block is never half queued.
+*
+*					If there isn't enough room, Tx_2_Queue_Full_Policy
+*					decides what happens: TX_BLOCK waits for room,
+*					TX_DROP_NEWEST throws away the whole block and
+*					TX_DROP_OLDEST throws away as many of the oldest queued
+*					bytes as needed.
+*
+*					Blocks larger than TX_2_QUEUE_SIZE are never accepted.
+*
+*					This function will not be included in the build unless
+*					ENABLE_SERIAL_PORT_TWO_TX is #define'd in serial_ports.h
+*
+*******************************************************************************/
+#ifdef ENABLE_SERIAL_PORT_TWO_TX
+unsigned char Write_Serial_Port_Two_Buffer(unsigned char *data, unsigned char count)
+{
+	Tx_2_Queue_Index_Type room;
+	Tx_2_Queue_Index_Type index;
+	unsigned char i;
+
+	if(count == 0 || count > TX_2_QUEUE_SIZE)
+	{
+		return(0);
+	}
+
+	// find out how much room there is. The interrupt service routine can
+	// only make more, so this is a safe lower bound.
+	PIE3bits.TX2IE = 0;
+	room = TX_2_QUEUE_SIZE - Tx_2_Queue_Byte_Count;
+	PIE3bits.TX2IE = 1;
+
+	if(room < count)
+	{
+		if(Tx_2_Queue_Full_Policy == TX_DROP_NEWEST)
+		{
+			// throw away the block we were asked to send
+			#ifdef ENABLE_SERIAL_PORT_STATS
+			Serial_Port_Two_Stats.tx_dropped += count;
+			#endif
+			return(0);
+		}
+		else if(Tx_2_Queue_Full_Policy == TX_DROP_OLDEST)
+		{
+			// make room by throwing away the oldest bytes in the queue,
+			// taking into account any sent since we last looked
+			PIE3bits.TX2IE = 0;
+
+			room = TX_2_QUEUE_SIZE - Tx_2_Queue_Byte_Count;
+
+			if(room < count)
+			{
+				Tx_2_Queue_Read_Index += count - room;
+				Tx_2_Queue_Read_Index &= TX_2_QUEUE_INDEX_MASK;
+				Tx_2_Queue_Byte_Count -= count - room;
+				Tx_2_Queue_Full = FALSE;
+
+				#ifdef ENABLE_SERIAL_PORT_STATS
+				Serial_Port_Two_Stats.tx_dropped += count - room;
+				#endif
+			}
+
+			PIE3bits.TX2IE = 1;
+		}
+		else
+		{
+			// wait here until enough space is available
+			#ifdef ENABLE_SERIAL_PORT_STATS
+			Serial_Port_Two_Stats.tx_full_waits++;
+			#endif
+			while(room < count)
+			{
+				PIE3bits.TX2IE = 0;
+				room = TX_2_QUEUE_SIZE - Tx_2_Queue_Byte_Count;
+				PIE3bits.TX2IE = 1;
+			}
+		}
+	}
+
+	// copy the data into the free part of the queue. The interrupt service
+	// routine doesn't look past Tx_2_Queue_Write_Index, so this doesn't
+	// need to be protected.
+	index = Tx_2_Queue_Write_Index;
+	for(i = 0; i < count; i++)
+	{
+		Tx_2_Queue[index] = data[i];
+		index++;
+		index &= TX_2_QUEUE_INDEX_MASK;
+	}
+
+	// now publish the whole block in one shot
+	PIE3bits.TX2IE = 0;
+
+	Tx_2_Queue_Write_Index = index;
+	Tx_2_Queue_Byte_Count += count;
+
+	#ifdef ENABLE_SERIAL_PORT_STATS
+	Serial_Port_Two_Stats.tx_bytes += count;
+	if(Tx_2_Queue_Byte_Count > Serial_Port_Two_Stats.tx_high_water)
+	{
+		Serial_Port_Two_Stats.tx_high_water = Tx_2_Queue_Byte_Count;
+	}
+	#endif
+
+	// is the circular queue now full?
+	if(Tx_2_Queue_Read_Index == Tx_2_Queue_Write_Index)
+	{ 
+		Tx_2_Queue_Full = TRUE;
+	}
 
-	// Since we've just added a byte to the queue, it can't possibly be empty.
-	// Again, this is quicker than using an if() statement every time
 	Tx_2_Queue_Empty = FALSE;
+
+	// turning the interrupt back on starts the transmitter if it was idle
+	PIE3bits.TX2IE = 1;
+
+	return(count);
 }
 #endif
 
@@ -926,6 +1523,10 @@ void Write_Serial_Port_Two(unsigned char byte)
 *					function will be called every time a new byte of data
 *					is received by serial port one.
 *
+*					If CAMERA_PARSE_IN_ISR is #define'd in camera.h and
+*					the camera is on this port, each byte is passed to
+*					Camera_State_Machine() instead of being queued.
+*
 *					This function will not be included in the build unless
 *					ENABLE_SERIAL_PORT_ONE_RX is #define'd in serial_ports.h		
 *
@@ -933,12 +1534,42 @@ void Write_Serial_Port_Two(unsigned char byte)
 #ifdef ENABLE_SERIAL_PORT_ONE_RX
 void Rx_1_Int_Handler(void)
 {
+	#ifdef CAMERA_STREAM_RX_1
+	unsigned char byte;
+
+	// the camera's serial data parser consumes the byte right
+	// away, so there's no queue to fill up
+	byte = RCREG1;
+
+	// reset the receiver circuitry if it has overrun
+	if(RCSTA1bits.OERR)
+	{
+		RCSTA1bits.CREN = 0;
+		RCSTA1bits.CREN = 1;
+		RX_1_Overrun_Errors++;
+	}
+
+	if(RCSTA1bits.FERR)
+	{
+		RX_1_Framing_Errors++;
+	}
+
+	#ifdef ENABLE_SERIAL_PORT_STATS
+	Serial_Port_One_Stats.rx_bytes++;
+	#endif
+
+	Camera_State_Machine(byte);
+	#else
 	if(Rx_1_Queue_Full)
 	{
 		// just turn off the serial port interrupt if we can't store any more data.
 		// the interrupt will be re-enabled within the Receive_Byte() function when
 		// more data is read.
 		PIE1bits.RC1IE = 0;
+
+		#ifdef ENABLE_SERIAL_PORT_STATS
+		Serial_Port_One_Stats.rx_full_stalls++;
+		#endif
 	}
 	else
 	{
@@ -974,6 +1605,14 @@ void Rx_1_Int_Handler(void)
 
 		// increment the queue byte count
 		Rx_1_Queue_Byte_Count++;
+
+		#ifdef ENABLE_SERIAL_PORT_STATS
+		Serial_Port_One_Stats.rx_bytes++;
+		if(Rx_1_Queue_Byte_Count > Serial_Port_One_Stats.rx_high_water)
+		{
+			Serial_Port_One_Stats.rx_high_water = Rx_1_Queue_Byte_Count;
+		}
+		#endif
 	
 		// increment the write pointer
 		Rx_1_Queue_Write_Index++;
@@ -994,6 +1633,7 @@ void Rx_1_Int_Handler(void)
 		// Again, this is quicker than using an if() statement every time
 		Rx_1_Queue_Empty = FALSE;
 	}
+	#endif
 }
 #endif
 
@@ -1013,6 +1653,10 @@ void Rx_1_Int_Handler(void)
 *					function will be called every time a new byte of data
 *					is received by serial port two.
 *
+*					If CAMERA_PARSE_IN_ISR is #define'd in camera.h and
+*					the camera is on this port, each byte is passed to
+*					Camera_State_Machine() instead of being queued.
+*
 *					This function will not be included in the build unless
 *					ENABLE_SERIAL_PORT_TWO_RX is #define'd in serial_ports.h 		
 *
@@ -1020,12 +1664,42 @@ void Rx_1_Int_Handler(void)
 #ifdef ENABLE_SERIAL_PORT_TWO_RX
 void Rx_2_Int_Handler(void)
 {
+	#ifdef CAMERA_STREAM_RX_2
+	unsigned char byte;
+
+	// the camera's serial data parser consumes the byte right
+	// away, so there's no queue to fill up
+	byte = RCREG2;
+
+	// reset the receiver circuitry if it has overrun
+	if(RCSTA2bits.OERR)
+	{
+		RCSTA2bits.CREN = 0;
+		RCSTA2bits.CREN = 1;
+		RX_2_Overrun_Errors++;
+	}
+
+	if(RCSTA2bits.FERR)
+	{
+		RX_2_Framing_Errors++;
+	}
+
+	#ifdef ENABLE_SERIAL_PORT_STATS
+	Serial_Port_Two_Stats.rx_bytes++;
+	#endif
+
+	Camera_State_Machine(byte);
+	#else
 	if(Rx_2_Queue_Full)
 	{
 		// just turn off the serial port interrupt if we can't store any more data.
 		// the interrupt will be re-enabled within the Receive_Byte() function when
 		// more data is read.
 		PIE3bits.RC2IE = 0;
+
+		#ifdef ENABLE_SERIAL_PORT_STATS
+		Serial_Port_Two_Stats.rx_full_stalls++;
+		#endif
 	}
 	else
 	{
@@ -1061,6 +1735,14 @@ void Rx_2_Int_Handler(void)
 
 		// increment the queue byte count
 		Rx_2_Queue_Byte_Count++;
+
+		#ifdef ENABLE_SERIAL_PORT_STATS
+		Serial_Port_Two_Stats.rx_bytes++;
+		if(Rx_2_Queue_Byte_Count > Serial_Port_Two_Stats.rx_high_water)
+		{
+			Serial_Port_Two_Stats.rx_high_water = Rx_2_Queue_Byte_Count;
+		}
+		#endif
 	
 		// increment the write pointer
 		Rx_2_Queue_Write_Index++;
@@ -1081,6 +1763,7 @@ void Rx_2_Int_Handler(void)
 		// Again, this is quicker than using an if() statement every time
 		Rx_2_Queue_Empty = FALSE;
 	}
+	#endif
 }
 #endif
 
@@ -1100,6 +1783,10 @@ void Rx_2_Int_Handler(void)
 *					function will be called every time serial port one is
 *					ready to start sending a byte of data.
 *
+*					As many bytes are sent as the USART will accept, which
+*					is two when it's idle: one goes straight to the shift
+*					register and the other waits in TXREG.
+*
 *					This function will not be included in the build unless
 *					ENABLE_SERIAL_PORT_ONE_TX is #define'd in serial_ports.h 		
 *
@@ -1116,30 +1803,48 @@ void Tx_1_Int_Handler(void)
 	}
 	else
 	{
-		// get a byte from the circular queue and send it to the USART
-		TXREG1 = Tx_1_Queue[Tx_1_Queue_Read_Index];
-
-		// decrement the queue byte count
-		Tx_1_Queue_Byte_Count--;
-
-		// increment the read pointer
-		Tx_1_Queue_Read_Index++;
-
-		// If the index pointer overflowed, cut-off the high-order bit. Doing this
-		// every time is quicker than checking for overflow every time with an if()
-		// statement and only then occasionally setting it back to zero. For this 
-		// to work, the queue size must be a power of 2 (e.g., 16,32,64,128...).
-		Tx_1_Queue_Read_Index &= TX_1_QUEUE_INDEX_MASK;
-
-		// is the circular queue now empty?
-		if(Tx_1_Queue_Read_Index == Tx_1_Queue_Write_Index)
+		// The USART has a transmit shift register behind TXREG, so when it's
+		// idle the byte we load moves straight through and TXREG is ready for
+		// another one. Keep loading bytes for as long as the USART will take
+		// them, so that a burst of data costs one interrupt per two bytes at
+		// most instead of one per byte.
+		do
 		{
-			Tx_1_Queue_Empty = TRUE;
+			// get a byte from the circular queue and send it to the USART
+			TXREG1 = Tx_1_Queue[Tx_1_Queue_Read_Index];
+
+			// decrement the queue byte count
+			Tx_1_Queue_Byte_Count--;
+
+			// increment the read pointer
+			Tx_1_Queue_Read_Index++;
+
+			// If the index pointer overflowed, cut-off the high-order bit. Doing this
+			// every time is quicker than checking for overflow every time with an if()
+			// statement and only then occasionally setting it back to zero. For this 
+			// to work, the queue size must be a power of 2 (e.g., 16,32,64,128...).
+			Tx_1_Queue_Read_Index &= TX_1_QUEUE_INDEX_MASK;
+
+			// is the circular queue now empty?
+			if(Tx_1_Queue_Read_Index == Tx_1_Queue_Write_Index)
+			{
+				Tx_1_Queue_Empty = TRUE;
+			}
+
+			// Since we've just removed a byte from the queue, it can't possibly be full.
+			// Again, this is quicker than using an if() statement every time
+			Tx_1_Queue_Full = FALSE;
+
+		// TXxIF isn't valid until the second instruction cycle after TXREGx is
+		// loaded, which the queue bookkeeping above more than covers
+		} while(!Tx_1_Queue_Empty && PIR1bits.TX1IF);
+
+		// if we've sent everything, turn the interrupt off now rather than
+		// taking another interrupt just to find the queue empty
+		if(Tx_1_Queue_Empty)
+		{
+			PIE1bits.TX1IE = 0;
 		}
-
- 		// Since we've just removed a byte from the queue, it can't possibly be full.
-		// Again, this is quicker than using an if() statement every time
-		Tx_1_Queue_Full = FALSE;
 	}
 }
 #endif
@@ -1160,6 +1865,10 @@ void Tx_1_Int_Handler(void)
 *					function will be called every time serial port two is
 *					ready to start sending a byte of data.
 *
+*					As many bytes are sent as the USART will accept, which
+*					is two when it's idle: one goes straight to the shift
+*					register and the other waits in TXREG.
+*
 *					This function will not be included in the build unless
 *					ENABLE_SERIAL_PORT_TWO_TX is #define'd in serial_ports.h 			
 *
@@ -1176,30 +1885,116 @@ void Tx_2_Int_Handler(void)
 	}
 	else
 	{
-		// get a byte from the circular queue and send it to the USART
-		TXREG2 = Tx_2_Queue[Tx_2_Queue_Read_Index];
+		// The USART has a transmit shift register behind TXREG, so when it's
+		// idle the byte we load moves straight through and TXREG is ready for
+		// another one. Keep loading bytes for as long as the USART will take
+		// them, so that a burst of data costs one interrupt per two bytes at
+		// most instead of one per byte.
+		do
+		{
+			// get a byte from the circular queue and send it to the USART
+			TXREG2 = Tx_2_Queue[Tx_2_Queue_Read_Index];
+
+			// decrement the queue byte count
+			Tx_2_Queue_Byte_Count--;
+
+			// increment the read pointer
+			Tx_2_Queue_Read_Index++;
+
+			// If the index pointer overflowed, cut-off the high-order bit. Doing this
+			// every time is quicker than checking for overflow every time with an if()
+			// statement and only then occasionally setting it back to zero. For this 
+			// to work, the queue size must be a power of 2 (e.g., 16,32,64,128...).
+			Tx_2_Queue_Read_Index &= TX_2_QUEUE_INDEX_MASK;
+
+			// is the circular queue now empty?
+			if(Tx_2_Queue_Read_Index == Tx_2_Queue_Write_Index)
+			{
+				Tx_2_Queue_Empty = TRUE;
+			}
+
+			// Since we've just removed a byte from the queue, it can't possibly be full.
+			// Again, this is quicker than using an if() statement every time
+			Tx_2_Queue_Full = FALSE;
+
+		// TXxIF isn't valid until the second instruction cycle after TXREGx is
+		// loaded, which the queue bookkeeping above more than covers
+		} while(!Tx_2_Queue_Empty && PIR3bits.TX2IF);
+
+		// if we've sent everything, turn the interrupt off now rather than
+		// taking another interrupt just to find the queue empty
+		if(Tx_2_Queue_Empty)
+		{
+			PIE3bits.TX2IE = 0;
+		}
+	}
+}
+#endif
 
-		// decrement the queue byte count
-		Tx_2_Queue_Byte_Count--;
+/*******************************************************************************
+*
+*	FUNCTION:		Serial_Get_Stats()
+*
+*	PURPOSE:		Returns a snapshot of a serial port's statistics.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Serial port (SERIAL_PORT_ONE or SERIAL_PORT_TWO) and
+*					a pointer to where the statistics should be copied.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The counters run from power-on and are never cleared.
+*					The high-water marks are the most bytes ever waiting
+*					in each queue, which is what's needed to size them.
+*
+*					A non-zero rx_full_stalls means data was lost because
+*					the consumer didn't empty the receive queue in time,
+*					whereas overrun errors without stalls point at the
+*					interrupt not being serviced quickly enough.
+*
+*					This function will not be included in the build unless
+*					ENABLE_SERIAL_PORT_STATS is #define'd in serial_ports.h
+*
+*******************************************************************************/
+#ifdef ENABLE_SERIAL_PORT_STATS
+void Serial_Get_Stats(unsigned char port, Serial_Port_Stats_Type *stats)
+{
+	unsigned char rx_interrupt_enabled;
 
-		// increment the read pointer
-		Tx_2_Queue_Read_Index++;
+	if(port == SERIAL_PORT_ONE)
+	{
+		// The receive side is updated in the interrupt service routine, so
+		// briefly disable the serial port interrupt while we copy. The
+		// interrupt may already be off because the receive queue is full,
+		// in which case it must stay off until the queue is read.
+		#ifdef ENABLE_SERIAL_PORT_ONE_RX
+		rx_interrupt_enabled = PIE1bits.RC1IE;
+		PIE1bits.RC1IE = 0;
+		#endif
 
-		// If the index pointer overflowed, cut-off the high-order bit. Doing this
-		// every time is quicker than checking for overflow every time with an if()
-		// statement and only then occasionally setting it back to zero. For this 
-		// to work, the queue size must be a power of 2 (e.g., 16,32,64,128...).
-		Tx_2_Queue_Read_Index &= TX_2_QUEUE_INDEX_MASK;
+		*stats = Serial_Port_One_Stats;
 
-		// is the circular queue now empty?
-		if(Tx_2_Queue_Read_Index == Tx_2_Queue_Write_Index)
-		{
-			Tx_2_Queue_Empty = TRUE;
-		}
+		#ifdef ENABLE_SERIAL_PORT_ONE_RX
+		stats->overrun_errors = RX_1_Overrun_Errors;
+		stats->framing_errors = RX_1_Framing_Errors;
+		PIE1bits.RC1IE = rx_interrupt_enabled;
+		#endif
+	}
+	else
+	{
+		#ifdef ENABLE_SERIAL_PORT_TWO_RX
+		rx_interrupt_enabled = PIE3bits.RC2IE;
+		PIE3bits.RC2IE = 0;
+		#endif
 
- 		// Since we've just removed a byte from the queue, it can't possibly be full.
-		// Again, this is quicker than using an if() statement every time
-		Tx_2_Queue_Full = FALSE;
+		*stats = Serial_Port_Two_Stats;
+
+		#ifdef ENABLE_SERIAL_PORT_TWO_RX
+		stats->overrun_errors = RX_2_Overrun_Errors;
+		stats->framing_errors = RX_2_Framing_Errors;
+		PIE3bits.RC2IE = rx_interrupt_enabled;
+		#endif
 	}
 }
 #endif
@@ -52,6 +52,10 @@
 // transmit functionality
 #define ENABLE_SERIAL_PORT_TWO_TX
 
+// comment out the next line to stop collecting the statistics
+// returned by Serial_Get_Stats()
+#define ENABLE_SERIAL_PORT_STATS
+
 // Sample values that can be plugged into the SPBRGx register to program the 
 // baud rate generator for a specific baud rate. Make sure to also set the BRGH
 // bit accordingly. See the Init_Serial_Port_One() and Init_Serial_Port_Two() 
@@ -80,18 +84,87 @@
 // to a queue size of 128. Another solution is to check for received serial data 
 // at a higher rate by putting the call to Read_Serial_Port_xxx() in the much 
 // faster Process_Data_From_Local_IO() loop. As mentioned above, these values 
-// must be a power of two (i.e.,8,16,32,64,128) for the circular queue algorithm 
-// to function correctly.
+// must be a power of two (i.e.,8,16,32,64,128,256,512,1024) for the circular 
+// queue algorithm to function correctly. The camera streams to serial port
+// two at 115,200 baud, or 302 bytes per 26.2ms, so its receive queue is 512
+// bytes.
+//
+// A queue larger than 128 bytes gets 16-bit indices and byte count (see the
+// xx_x_Queue_Index_Type definitions below), which cost a little more time
+// to update. All four queues are placed in the SERIAL_QUEUES section, which
+// the linker script maps onto a block of general purpose RAM banks, so their
+// combined size must not exceed the size of that block. SERIAL_QUEUES_RAM_SIZE
+// must match the "serial" DATABANK in 18f8722.lkr; grow both together if a
+// queue needs to be larger.
 #define RX_1_QUEUE_SIZE 32
 #define TX_1_QUEUE_SIZE 32
-#define RX_2_QUEUE_SIZE 32
+#define RX_2_QUEUE_SIZE 512
 #define TX_2_QUEUE_SIZE 32
 
+#define SERIAL_QUEUES_RAM_SIZE 768
+
+#if RX_1_QUEUE_SIZE + TX_1_QUEUE_SIZE + RX_2_QUEUE_SIZE + TX_2_QUEUE_SIZE > SERIAL_QUEUES_RAM_SIZE
+#error "The serial port queues don't fit in the SERIAL_QUEUES section"
+#endif
+
+// What Write_Serial_Port_xxx() does when a transmit queue is full. TX_BLOCK
+// waits for the interrupt service routine to make room, which can hold up
+// the 26.2ms loop for as long as it takes to send the whole queue. The
+// other two policies never wait, but lose data: TX_DROP_NEWEST throws away
+// the byte being written and TX_DROP_OLDEST throws away the oldest byte
+// waiting to be sent. The policy can be changed at any time through the
+// Tx_x_Queue_Full_Policy variables.
+#define TX_BLOCK		0
+#define TX_DROP_NEWEST	1
+#define TX_DROP_OLDEST	2
+
+#define TX_1_FULL_POLICY TX_BLOCK
+#define TX_2_FULL_POLICY TX_BLOCK
+
 // The circular queue algorithm will break if these values are altered.
-#define RX_1_QUEUE_INDEX_MASK RX_1_QUEUE_SIZE-1
-#define TX_1_QUEUE_INDEX_MASK TX_1_QUEUE_SIZE-1
-#define RX_2_QUEUE_INDEX_MASK RX_2_QUEUE_SIZE-1
-#define TX_2_QUEUE_INDEX_MASK TX_2_QUEUE_SIZE-1
+#define RX_1_QUEUE_INDEX_MASK (RX_1_QUEUE_SIZE-1)
+#define TX_1_QUEUE_INDEX_MASK (TX_1_QUEUE_SIZE-1)
+#define RX_2_QUEUE_INDEX_MASK (RX_2_QUEUE_SIZE-1)
+#define TX_2_QUEUE_INDEX_MASK (TX_2_QUEUE_SIZE-1)
+
+// Index and byte count types for each queue, picked to match the queue
+// size. An eight-bit byte count can't tell a full 256 byte queue from an
+// empty one, so 16 bits are used for anything larger than 128 bytes.
+#if RX_1_QUEUE_SIZE > 128
+typedef unsigned int Rx_1_Queue_Index_Type;
+#else
+typedef unsigned char Rx_1_Queue_Index_Type;
+#endif
+
+#if TX_1_QUEUE_SIZE > 128
+typedef unsigned int Tx_1_Queue_Index_Type;
+#else
+typedef unsigned char Tx_1_Queue_Index_Type;
+#endif
+
+#if RX_2_QUEUE_SIZE > 128
+typedef unsigned int Rx_2_Queue_Index_Type;
+#else
+typedef unsigned char Rx_2_Queue_Index_Type;
+#endif
+
+#if TX_2_QUEUE_SIZE > 128
+typedef unsigned int Tx_2_Queue_Index_Type;
+#else
+typedef unsigned char Tx_2_Queue_Index_Type;
+#endif
+
+// These macros let a consumer look at received data in place, without
+// copying it out of the circular queue one byte at a time. Offset zero
+// is the oldest byte in the queue. Only offsets less than the value
+// last returned by Serial_Port_xxx_Byte_Count() are valid, and the
+// bytes must be given back with Release_Serial_Port_xxx() once they've
+// been used. The interrupt service routine never writes to that part
+// of the queue, so no interrupt masking is needed while peeking.
+#define PEEK_SERIAL_PORT_ONE(offset) \
+	(Rx_1_Queue[(Rx_1_Queue_Read_Index + (offset)) & (RX_1_QUEUE_INDEX_MASK)])
+#define PEEK_SERIAL_PORT_TWO(offset) \
+	(Rx_2_Queue[(Rx_2_Queue_Read_Index + (offset)) & (RX_2_QUEUE_INDEX_MASK)])
 
 #ifndef FALSE
 #define TRUE 1
@@ -103,15 +176,35 @@
 #define SERIAL_PORT_ONE 1
 #define SERIAL_PORT_TWO 2
 
+// serial port statistics returned by Serial_Get_Stats()
+typedef struct
+{
+	unsigned long rx_bytes;			// bytes received
+	unsigned long tx_bytes;			// bytes queued for transmission
+	unsigned int rx_high_water;		// most bytes ever in the receive queue
+	unsigned int tx_high_water;		// most bytes ever in the transmit queue
+	unsigned int rx_full_stalls;	// times the receive interrupt was turned off
+									// because the receive queue was full
+	unsigned int tx_full_waits;		// times Write_Serial_Port_xxx() had to wait
+									// for room in the transmit queue
+	unsigned int tx_dropped;		// bytes thrown away because the transmit
+									// queue was full (see TX_DROP_NEWEST)
+	unsigned char overrun_errors;	// copy of RX_x_Overrun_Errors
+	unsigned char framing_errors;	// copy of RX_x_Framing_Errors
+}	Serial_Port_Stats_Type;
+
 // if needed, declare functions and global variables that
 // are specific to serial port one receiver functionality
 #ifdef ENABLE_SERIAL_PORT_ONE_RX
 void Init_Serial_Port_One(void);
-unsigned char Serial_Port_One_Byte_Count(void);
+Rx_1_Queue_Index_Type Serial_Port_One_Byte_Count(void);
 unsigned char Read_Serial_Port_One(void);
+void Release_Serial_Port_One(Rx_1_Queue_Index_Type);
 void Rx_1_Int_Handler(void);
 extern volatile unsigned char RX_1_Framing_Errors;
 extern volatile unsigned char RX_1_Overrun_Errors;
+extern volatile unsigned char Rx_1_Queue[RX_1_QUEUE_SIZE];
+extern Rx_1_Queue_Index_Type Rx_1_Queue_Read_Index;
 #endif
 
 // if needed, declare functions that are specific to serial
@@ -121,6 +214,9 @@ extern unsigned char stdout_serial_port;
 void _user_putc(unsigned char);
 void Init_Serial_Port_One(void);
 void Write_Serial_Port_One(unsigned char);
+unsigned char Try_Write_Serial_Port_One(unsigned char);
+unsigned char Write_Serial_Port_One_Buffer(unsigned char *, unsigned char);
+extern unsigned char Tx_1_Queue_Full_Policy;
 void Tx_1_Int_Handler(void);
 #endif
 
@@ -128,11 +224,14 @@ void Tx_1_Int_Handler(void);
 // are specific to serial port two receiver functionality
 #ifdef ENABLE_SERIAL_PORT_TWO_RX
 void Init_Serial_Port_Two(void);
-unsigned char Serial_Port_Two_Byte_Count(void);
+Rx_2_Queue_Index_Type Serial_Port_Two_Byte_Count(void);
 unsigned char Read_Serial_Port_Two(void);
+void Release_Serial_Port_Two(Rx_2_Queue_Index_Type);
 void Rx_2_Int_Handler(void);
 extern volatile unsigned char RX_2_Framing_Errors;
 extern volatile unsigned char RX_2_Overrun_Errors;
+extern volatile unsigned char Rx_2_Queue[RX_2_QUEUE_SIZE];
+extern Rx_2_Queue_Index_Type Rx_2_Queue_Read_Index;
 #endif
 
 // if needed, declare functions that are specific to serial
@@ -142,7 +241,14 @@ extern unsigned char stdout_serial_port;
 void _user_putc(unsigned char);
 void Init_Serial_Port_Two(void);
 void Write_Serial_Port_Two(unsigned char);
+unsigned char Try_Write_Serial_Port_Two(unsigned char);
+unsigned char Write_Serial_Port_Two_Buffer(unsigned char *, unsigned char);
+extern unsigned char Tx_2_Queue_Full_Policy;
 void Tx_2_Int_Handler(void);
 #endif
 
+#ifdef ENABLE_SERIAL_PORT_STATS
+void Serial_Get_Stats(unsigned char, Serial_Port_Stats_Type *);
+#endif
+
 #endif
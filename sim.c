@@ -0,0 +1,368 @@
+/*******************************************************************************
+*
+*	TITLE:		sim.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	This file implements a stand-in for the master uP that is
+*				used by the host build, which runs the robot code as an
+*				ordinary Linux program (see host/host.c). _SIMULATOR is
+*				#define'd for that build.
+*
+*				Getdata() and Putdata() are routed here by sim.h.
+*				Sim_Getdata() hands the user code a scripted rx_data_record
+*				that plays out a full match: autonomous mode for
+*				SIM_AUTONOMOUS_LOOPS slow loops followed by operator
+*				control for SIM_TELEOP_LOOPS slow loops, with the port one
+*				joystick and the port four buttons exercised by a
+*				pseudo-random sequence picked by the match seed.
+*				Sim_Putdata() plays the part of the master uP receiving
+*				our outputs: it folds the PWM and LED bytes into a
+*				signature that can be compared between builds, records
+*				how long the slow loop took and what the tracking code
+*				was doing, then moves the camera and robot model on to
+*				the next frame. At the end of the match Sim_Report()
+*				hands the results to the host code, which runs the next
+*				match in a fresh process and prints a summary once all
+*				of them are done.
+*
+*				To use the simulator:
+*
+*				  1) Run "make -C host" on a Linux machine with gcc.
+*
+*				  2) Run "host/frc_sim [-m matches] [-s seed] [-v]". -m sets
+*				  the number of matches (1000 if not given), -s the seed
+*				  of the first match (each match after that uses the next
+*				  seed) and -v prints each match's results and whatever
+*				  the robot code sends to the terminal port.
+*
+*				Loop times are host times, so they're only good for
+*				comparing one build with another on the same machine.
+*				The host's int is 32 bits where C18's is 16, so code
+*				that relies on 16-bit wraparound (e.g., Timer3
+*				differences in profile.c) may behave differently. The
+*				serial ports are infinitely fast on the host; the host
+*				code reports slow loops that would have sent more than
+*				a 115200 baud port can carry instead.
+*
+*				This file is empty unless _SIMULATOR is #define'd.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include <stdio.h>
+#include "ifi_default.h"
+#include "ifi_aliases.h"
+#include "camera.h"
+#include "tracking.h"
+#include "sim.h"
+#include "host.h"
+
+#ifdef _SIMULATOR
+
+// what this match has done so far
+Sim_Match_Result_Type Sim_Match_Result;
+
+// this match's seed and the slow loop within the match
+unsigned int sim_match_seed = 0;
+unsigned int sim_match_loop = 0;
+
+// the frame the master uP will hand us on the next call to Getdata()
+static rx_data_record sim_rxdata;
+
+// pseudo-random number generator state for the scripted inputs
+static unsigned int sim_lfsr = 0xACE1;
+
+// host clock at the end of the previous slow loop
+static unsigned long sim_last_clock;
+static unsigned char sim_clock_valid = 0;
+
+/*******************************************************************************
+*
+*	FUNCTION:		Sim_Random()
+*
+*	PURPOSE:		Returns the next value of a 16-bit Galois LFSR. The
+*					sequence depends only on the match seed, which makes
+*					simulated matches repeatable.
+*
+*	CALLED FROM:	Sim_Next_Frame(), below.
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		unsigned int
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+static unsigned int Sim_Random(void)
+{
+	unsigned char lsb;
+
+	lsb = (unsigned char)(sim_lfsr & 1);
+	sim_lfsr >>= 1;
+	if(lsb)
+	{
+		sim_lfsr ^= 0xB400;
+	}
+	return(sim_lfsr);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Sim_Next_Frame()
+*
+*	PURPOSE:		Builds the rx_data_record the master uP would send us
+*					during the next slow loop of the scripted match.
+*
+*	CALLED FROM:	Sim_Initialize() and Sim_Putdata(), this file.
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The joystick wanders in small random steps, drifting
+*					back toward center the way a driver lets it settle, so
+*					the robot turns now and then instead of spinning in
+*					place all match.
+*
+*******************************************************************************/
+static void Sim_Next_Frame(void)
+{
+	unsigned int random;
+	int axis;
+
+	sim_rxdata.packet_num++;
+
+	// play out autonomous mode, then operator control
+	sim_rxdata.rc_mode_byte.allbits = 0;
+	if(sim_match_loop < SIM_AUTONOMOUS_LOOPS)
+	{
+		sim_rxdata.rc_mode_byte.mode.autonomous = 1;
+	}
+
+	random = Sim_Random();
+
+	// random walk of the port one joystick x-axis
+	axis = (int)sim_rxdata.oi_analog05 + (int)(random & 0x0F) - 8;
+	axis -= ((int)sim_rxdata.oi_analog05 - 127) / 8;
+	if(axis < 0) axis = 0;
+	if(axis > 254) axis = 254;
+	sim_rxdata.oi_analog05 = (unsigned char)axis;
+
+	// random walk of the port one joystick y-axis
+	axis = (int)sim_rxdata.oi_analog01 + (int)((random >> 4) & 0x0F) - 8;
+	axis -= ((int)sim_rxdata.oi_analog01 - 127) / 8;
+	if(axis < 0) axis = 0;
+	if(axis > 254) axis = 254;
+	sim_rxdata.oi_analog01 = (unsigned char)axis;
+
+	// every so often, press one of the port four buttons for a few loops
+	sim_rxdata.oi_swB_byte.allbits = 0;
+	if((sim_match_loop & 0x7F) < 4)
+	{
+		sim_rxdata.oi_swB_byte.allbits = (unsigned char)(0x10 << ((random >> 8) & 0x03));
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Sim_Initialize()
+*
+*	PURPOSE:		Starts the matches and loads the first frame of this
+*					one.
+*
+*	CALLED FROM:	main.c/main()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Must be called before User_Initialization(). Only
+*					returns in the process that runs the match; see
+*					host.c/Host_Start_Match().
+*
+*******************************************************************************/
+void Sim_Initialize(void)
+{
+	unsigned char i;
+
+	sim_match_seed = Host_Start_Match();
+
+	// seed zero gives the original sequence; the LFSR can't start at zero
+	sim_lfsr = 0xACE1 ^ ((sim_match_seed * 0x9E37) & 0xFFFF);
+	if(sim_lfsr == 0)
+	{
+		sim_lfsr = 0xACE1;
+	}
+
+	Sim_Match_Result.loops = 0;
+	Sim_Match_Result.min_ns = 0xFFFFFFFFUL;
+	Sim_Match_Result.max_ns = 0;
+	Sim_Match_Result.total_ns = 0;
+	Sim_Match_Result.signature = 0;
+	Sim_Match_Result.t_packets = 0;
+	Sim_Match_Result.aimed_loops = 0;
+	Sim_Match_Result.searching_loops = 0;
+	Sim_Match_Result.shot_ready_loops = 0;
+
+	// all analog inputs start out centered
+	for(i = 0; i < sizeof(rx_data_record); i++)
+	{
+		((unsigned char *)(&sim_rxdata))[i] = 0;
+	}
+	sim_rxdata.oi_analog01 = sim_rxdata.oi_analog02 = 127;
+	sim_rxdata.oi_analog03 = sim_rxdata.oi_analog04 = 127;
+	sim_rxdata.oi_analog05 = sim_rxdata.oi_analog06 = 127;
+	sim_rxdata.oi_analog07 = sim_rxdata.oi_analog08 = 127;
+	sim_rxdata.oi_analog09 = sim_rxdata.oi_analog10 = 127;
+	sim_rxdata.oi_analog11 = sim_rxdata.oi_analog12 = 127;
+	sim_rxdata.oi_analog13 = sim_rxdata.oi_analog14 = 127;
+	sim_rxdata.oi_analog15 = sim_rxdata.oi_analog16 = 127;
+	sim_rxdata.rc_main_batt = 190;
+	sim_rxdata.rc_backup_batt = 130;
+
+	Sim_Next_Frame();
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Sim_Getdata()
+*
+*	PURPOSE:		Stand-in for Getdata() in the host build.
+*
+*	CALLED FROM:	user_routines.c and user_routines_fast.c, via the
+*					Getdata() macro in sim.h
+*
+*	PARAMETERS:		Pointer to the receive buffer.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Like the real thing, calling this more than once per
+*					slow loop returns the same frame.
+*
+*******************************************************************************/
+void Sim_Getdata(rx_data_ptr ptr)
+{
+	unsigned char i;
+
+	for(i = 0; i < sizeof(rx_data_record); i++)
+	{
+		((unsigned char *)ptr)[i] = ((unsigned char *)(&sim_rxdata))[i];
+	}
+
+	statusflag.NEW_SPI_DATA = 0;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Sim_Putdata()
+*
+*	PURPOSE:		Stand-in for Putdata() in the host build. Marks the
+*					end of a slow loop.
+*
+*	CALLED FROM:	user_routines.c and user_routines_fast.c, via the
+*					Putdata() macro in sim.h
+*
+*	PARAMETERS:		Pointer to the transmit buffer.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The cost of a slow loop is the time between two
+*					consecutive calls to Putdata(), so it includes whatever
+*					the fast loop did in between, but not the time spent
+*					here and in the camera model.
+*
+*******************************************************************************/
+void Sim_Putdata(tx_data_ptr ptr)
+{
+	unsigned long now;
+	unsigned long cost;
+	unsigned char i;
+
+	now = Host_Clock();
+
+	// the first Putdata() comes from User_Initialization() and
+	// doesn't close a slow loop
+	if(sim_clock_valid)
+	{
+		cost = now - sim_last_clock;
+
+		Sim_Match_Result.loops++;
+		Sim_Match_Result.total_ns += cost;
+		if(cost < Sim_Match_Result.min_ns)
+		{
+			Sim_Match_Result.min_ns = cost;
+		}
+		if(cost > Sim_Match_Result.max_ns)
+		{
+			Sim_Match_Result.max_ns = cost;
+		}
+
+		// fold the PWM and LED outputs into the regression signature
+		for(i = 0; i < 20; i++)
+		{
+			Sim_Match_Result.signature = (Sim_Match_Result.signature * 31 + ((unsigned char *)ptr)[i]) & 0xFFFFFFFFUL;
+		}
+
+		// what the tracking code made of this frame
+		if(Tracking_State.State == TRACKING_AIMED)
+		{
+			Sim_Match_Result.aimed_loops++;
+		}
+		else if(Tracking_State.State == TRACKING_SEARCHING)
+		{
+			Sim_Match_Result.searching_loops++;
+		}
+		if(Tracking_Shot_Ready())
+		{
+			Sim_Match_Result.shot_ready_loops++;
+		}
+
+		sim_match_loop++;
+
+		if(sim_match_loop >= SIM_AUTONOMOUS_LOOPS + SIM_TELEOP_LOOPS)
+		{
+			Sim_Report();
+		}
+	}
+
+	// move the world on, then load the next frame
+	Host_Advance(ptr);
+	Sim_Next_Frame();
+
+	// don't charge the camera model or frame generation to the next slow loop
+	sim_last_clock = Host_Clock();
+	sim_clock_valid = 1;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Sim_Report()
+*
+*	PURPOSE:		Ends the match, handing its results to the host code.
+*
+*	CALLED FROM:	Sim_Putdata(), above.
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Doesn't.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+void Sim_Report(void)
+{
+	Sim_Match_Result.t_packets = camera_t_packets;
+
+	Host_End_Match(&Sim_Match_Result);
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*******************************************************************************
+*
+*	TITLE:		sim.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Stand-in master uP for the host build. See sim.c for
+*				details.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _SIM_H
+#define _SIM_H
+
+#ifdef _SIMULATOR
+
+// Length, in slow loops, of each phase of a simulated match. The
+// real field runs 15 seconds of autonomous followed by 120 seconds
+// of operator control, which works out to 572 and 4580 loops.
+#define SIM_AUTONOMOUS_LOOPS 572
+#define SIM_TELEOP_LOOPS 4580
+
+// what one simulated match did
+typedef struct
+{
+	unsigned long loops;			// number of slow loops measured
+	unsigned long min_ns;			// cheapest slow loop, in host nanoseconds
+	unsigned long max_ns;			// most expensive slow loop
+	unsigned long total_ns;			// sum of all measured slow loops
+	unsigned long signature;		// signature of every frame sent to the master uP
+	unsigned long t_packets;		// T packets the camera code received
+	unsigned long aimed_loops;		// slow loops with the turret aimed
+	unsigned long searching_loops;	// slow loops spent searching
+	unsigned long shot_ready_loops;	// slow loops with Tracking_Shot_Ready() set
+}	Sim_Match_Result_Type;
+
+// global variables
+extern Sim_Match_Result_Type Sim_Match_Result;
+extern unsigned int sim_match_seed;
+extern unsigned int sim_match_loop;
+
+// Route the IFI SPI exchange through the stand-in master uP. These
+// must come after ifi_default.h in every file that includes them.
+#define Getdata(ptr) Sim_Getdata(ptr)
+#define Putdata(ptr) Sim_Putdata(ptr)
+
+// function prototypes
+void Sim_Initialize(void);
+void Sim_Getdata(rx_data_ptr);
+void Sim_Putdata(tx_data_ptr);
+void Sim_Report(void);
+
+#endif
+
+#endif
@@ -0,0 +1,154 @@
+/*******************************************************************************
+*
+*	TITLE:		slew.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	This file limits how fast the turret, tilt servo and
+*				drive PWM commands can change, so that a large step in
+*				a command is spread over several frames rather than
+*				jerking the mechanism.
+*
+*				pwm01 through pwm12 are generated by the master
+*				processor from the frame sent by Putdata() every 26.2ms,
+*				so values written to them between frames never reach
+*				the outputs. The limiting is therefore done once per
+*				frame, just before Putdata().
+*
+*				Whatever the rest of the code leaves in an output when
+*				Slew_Outputs() is called is taken as where that output
+*				should go, and the output is moved at most the maximum
+*				step (see slew.h) toward it. Code that moves an output
+*				by a fixed amount only once, like the tilt legs of the
+*				search pattern, must keep writing its target every
+*				frame until it gets there.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include "ifi_default.h"
+#include "ifi_aliases.h"
+#include "tracking.h"
+#include "slew.h"
+
+// outputs sent in the last frame
+static unsigned char last_pan = 127;
+static unsigned char last_tilt = 127;
+static unsigned char last_drive[4] = {127, 127, 127, 127};
+
+static unsigned char Slew_Limit(unsigned char, unsigned char *, unsigned char);
+
+/*******************************************************************************
+*
+*	FUNCTION:		Slew_Outputs()
+*
+*	PURPOSE:		Limits the change in the turret, tilt servo and drive
+*					commands since the last frame.
+*
+*	CALLED FROM:	user_routines.c/Process_Data_From_Master_uP()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Call once per frame, just before Putdata().
+*
+*******************************************************************************/
+void Slew_Outputs(void)
+{
+	Slew_Camera_Outputs();
+
+	pwm01 = Slew_Limit(pwm01, &last_drive[0], SLEW_DRIVE_MAX_STEP);
+	pwm02 = Slew_Limit(pwm02, &last_drive[1], SLEW_DRIVE_MAX_STEP);
+	pwm03 = Slew_Limit(pwm03, &last_drive[2], SLEW_DRIVE_MAX_STEP);
+	pwm04 = Slew_Limit(pwm04, &last_drive[3], SLEW_DRIVE_MAX_STEP);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Slew_Camera_Outputs()
+*
+*	PURPOSE:		Limits the change in the turret and tilt servo commands
+*					since the last frame.
+*
+*	CALLED FROM:	Slew_Outputs(), above,
+*					user_routines_fast.c/User_Autonomous_Code()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Call once per frame. The autonomous code sets the drive
+*					commands from its own schedule outside of the 26.2ms
+*					loop area, so it only limits these two.
+*
+*******************************************************************************/
+void Slew_Camera_Outputs(void)
+{
+	PAN_SERVO = Slew_Limit(PAN_SERVO, &last_pan, SLEW_PAN_MAX_STEP);
+	TILT_SERVO = Slew_Limit(TILT_SERVO, &last_tilt, SLEW_TILT_MAX_STEP);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Get_Last_Pan()
+*
+*	PURPOSE:		Returns the turret command sent in the last frame.
+*
+*	CALLED FROM:	tracking.c/Turret_Estimate_Update()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		PWM command.
+*
+*	COMMENTS:		PAN_SERVO itself can't be used, because the rest of
+*					the code writes it again after Putdata().
+*
+*******************************************************************************/
+unsigned char Get_Last_Pan(void)
+{
+	return(last_pan);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Slew_Limit()
+*
+*	PURPOSE:		Moves one output toward its commanded value.
+*
+*	CALLED FROM:	Slew_Outputs() and Slew_Camera_Outputs(), above.
+*
+*	PARAMETERS:		Commanded value, pointer to the value sent in the last
+*					frame (updated here) and the maximum step.
+*
+*	RETURNS:		Value to send in this frame.
+*
+*	COMMENTS:		A maximum step of zero sends the commanded value.
+*
+*******************************************************************************/
+static unsigned char Slew_Limit(unsigned char command, unsigned char *last, unsigned char max_step)
+{
+	if(max_step != 0)
+	{
+		if(command > *last && command - *last > max_step)
+		{
+			command = *last + max_step;
+		}
+		else if(command < *last && *last - command > max_step)
+		{
+			command = *last - max_step;
+		}
+	}
+
+	*last = command;
+
+	return(command);
+}
@@ -0,0 +1,35 @@
+/*******************************************************************************
+*
+*	TITLE:		slew.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	PWM output slew rate limiting. See slew.c for details.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _SLEW_H
+#define _SLEW_H
+
+// Largest change, in PWM counts, each output is allowed to make from
+// one frame sent to the master processor to the next (26.2ms). Zero
+// turns the limit off for that output.
+#define SLEW_PAN_MAX_STEP 16	// turret motor (PAN_SERVO)
+#define SLEW_TILT_MAX_STEP 6	// camera tilt servo (TILT_SERVO)
+#define SLEW_DRIVE_MAX_STEP 0	// drive motors (pwm01 through pwm04)
+
+// function prototypes
+void Slew_Outputs(void);
+void Slew_Camera_Outputs(void);
+unsigned char Get_Last_Pan(void);
+
+#endif
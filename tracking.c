@@ -33,6 +33,9 @@
 #include "eeprom.h"
 #include "camera.h"
 #include "tracking.h"
+#include "yaw.h"
+#include "range.h"
+#include "slew.h"
 
 // This variable, when equal to one, indicates that the tracking 
 // software has successfully initialized and should be running. 
@@ -43,12 +46,44 @@ unsigned char tracking_initialized = 0;
 // tracking configuration data structure
 Tracking_Config_Data_Type Tracking_Config_Data;
 
+// tracking state structure
+Tracking_State_Type Tracking_State = {TRACKING_SEARCHING, 0, 0, 0, 0, RANGE_UNKNOWN, 0};
+
+// pan controller state. The integral is kept in sixteenths of a
+// PWM count.
+static long pan_integral = 0;
+static unsigned char pan_last_mx = 0;
+static unsigned char pan_controller_primed = 0;
+
+// Search planner state. The search is a square spiral that starts
+// where the target was last seen: a pan leg, a tilt leg, then pan
+// and tilt legs one step longer in the opposite directions, and so
+// on. Pan legs run the turret motor, tilt legs step the tilt servo.
+static unsigned char search_timer = 0;		// slow loops into this step
+static unsigned char search_leg_length = 1;	// steps in this leg
+static unsigned char search_leg_steps = 0;	// steps taken in this leg
+static unsigned char search_pan_leg = 1;	// one if this is a pan leg
+static char search_pan_direction = 1;
+static char search_tilt_direction = 1;
+static int search_pan_center = 0;			// turret estimate at the start
+static unsigned char search_returning = 0;	// one on the leg back to it
+static int search_tilt_target = 127;		// tilt servo command
+
+// Estimate of where the turret is pointed, in hundredths of a degree
+// from straight ahead. Positive is the way a positive pan error turns
+// it. See Turret_Estimate_Update().
+static int turret_estimate = 0;
+
+static void Turret_Estimate_Update(void);
+static void Start_Search(int);
+static int Search_Step(int);
+
 /*******************************************************************************
 *
 *	FUNCTION:		Servo_Track()
 *
-*	PURPOSE:		This function reads data placed in the T_Packet_Data
-*					structure by the Camera_Handler() function and if new
+*	PURPOSE:		This function reads the latest T packet from the camera
+*					code using Camera_Get_Latest_Packet() and if new
 *					tracking data is available, attempts to keep the center
 *					of the tracked object in the center of the camera's
 *					image using two servos that drive a pan/tilt platform.
@@ -58,65 +93,32 @@ Tracking_Config_Data_Type Tracking_Config_Data;
 *
 *	CALLED FROM:	user_routines.c/Process_Data_From_Master_uP()
 *
-*	PARAMETERS:		None.
+*	PARAMETERS:		Right and left drive motor commands.
 *
 *	RETURNS:		Nothing.
 *
-*	COMMENTS:		This version of the tracking code uses a proportional
-*					feedback controller to track the object.
+*	COMMENTS:		This version of the tracking code uses a PID controller
+*					to track the object.
+*
+*					The results are left in Tracking_State, including the
+*					range estimate from Range_Update() in range.c. The
+*					state only changes when a new T packet arrives.
 *
 *******************************************************************************/
-int Servo_Track(int driveR, int driveL)
+void Servo_Track(int driveR, int driveL)
 {
-	static unsigned int old_camera_t_packets = 0;
+	static unsigned char old_t_packet_sequence = 0;
+	T_Packet_Data_Type t_packet;
+	unsigned char t_packet_sequence;
 	static unsigned char new_search = 1;
-	static unsigned char loop_count = 0;
-	int temp_pan_servo;
 	int temp_tilt_servo;
 	int servo_step;
 	int pan_error;
 	int tilt_error;
-	int velocityToStart = 0;
-	int turnVelocity = 1;
-	int searchSpeed = 1;
-	int letMyAimBeTrue = 0;
-	int driveDifferential = 0;
-	int driveDifferentialCorrection = 0;
-	int driveDifferentialThreshold = 6;
-	int position = 0;
-
-	// Starts at 10
-	const int hood_angle[] = {32, 32, 32, 32, 32, 30, 28, 27, 26, 26,
-							 26, 26, 26, 26, 26, 26, 26, 26, 32, 32,
-							 27, 28, 28, 28, 29, 30, 30, 31, 31, 33 };
 
 
 	
 
-	// calculate drive differential and change into pan speed
-	// pwm01 is right motor, pwm03 is left motor
-	// positive differential is counter-clockwise rotation
-	// negative differential is clockwise rotation
-	/*
-	if ((driveR == driveL) && ((driveR > 200) || (driveR < 50)))
-	{
-		if (driveR > 200)
-			driveDifferentialCorrection = 10;
-		else if (driveR < 50)
-			driveDifferentialCorrection = -10;
-	}
-	*/
-	/*
-
-	driveDifferential = driveR + driveL;
-	if (driveDifferential > driveDifferentialThreshold)
-		driveDifferentialCorrection = driveDifferential + 8;
-	else if  (-1 * driveDifferential < driveDifferentialThreshold)
-		driveDifferentialCorrection = driveDifferential - 8;
-	else
-		driveDifferential = 0;
-	*/
-	
 	// if needed, (re)initialize the tracking code
 	if(tracking_initialized == 0)
 	{
@@ -124,18 +126,27 @@ int Servo_Track(int driveR, int driveL)
 		Initialize_Tracking();
 	}
 
+	// update the estimate of how fast the robot is turning
+	Yaw_Update(driveR, driveL);
+
+	// and of where the last turret command took the turret
+	Turret_Estimate_Update();
+
+	// get a consistent copy of the most recent camera t-packet
+	Camera_Get_Latest_Packet(&t_packet, &t_packet_sequence);
+
 	// Has a new camera t-packet arrived since we last checked?
-	if(camera_t_packets != old_camera_t_packets)
+	if(t_packet_sequence != old_t_packet_sequence)
 	{
 
-		old_camera_t_packets = camera_t_packets;
+		old_t_packet_sequence = t_packet_sequence;
 
 		// Does the camera have a tracking solution? If so,
 		// do we need to move the servos to keep the center
 		// of the tracked object centered within the image?
 		// If not, we need to drop down below to start or
 		// continue a search
-		if(T_Packet_Data.my != 0)
+		if(t_packet.my != 0)
 		{
 			// if we're tracking, reset the search
 			// algorithm so that a new search pattern
@@ -149,98 +160,32 @@ int Servo_Track(int driveR, int driveL)
 			////////////////////////////////
 
 
-			// save the current pan servo PWM value into a local
-			// integer variable so that we can detect and correct 
-			// underflow and overflow conditions before we update 
-			// the pan servo PWM value with a new value
-			temp_pan_servo = (int)PAN_SERVO;
-
 			// calculate how many image pixels we're away from the
 			// vertical center line.
-			pan_error = (int)T_Packet_Data.mx - (int)Tracking_Config_Data.Pan_Target_Pixel;
-
-			// Are we too far to the left or right of the vertical 
-			// center line? If so, calculate how far we should step
-			// the pan servo to reduce the error.
-			if(pan_error > (int)Tracking_Config_Data.Pan_Allowable_Error)
-			{
-				// calculate how far we need to step the pan servo
-				servo_step = pan_error / (int)Tracking_Config_Data.Pan_Gain;
-
-				// Due to rounding error in the division calculation above,
-				// the step may be calculated as zero, which will make it
-				// impossible to converge on the target when x_error is
-				// smaller than X_GAIN. To get around this problem, we just 
-				// test for the zero case and set the step size to one. 
-				if(servo_step == 0)
-				{
-					servo_step = 1;
-				}
-			}
-			else if(pan_error < -1 * (int)Tracking_Config_Data.Pan_Allowable_Error)
-			{
-				// calculate how far we need to step the pan servo
-				servo_step = pan_error / (int)Tracking_Config_Data.Pan_Gain;
-
-				// Due to rounding error in the division calculation above,
-				// the step may be calculated as zero, which will make it
-				// impossible to converge on the target when x_error is
-				// smaller than X_GAIN. To get around this problem, we just 
-				// test for the zero case and set the step size to one. 
-				if(servo_step == 0)
-				{
-					servo_step = -1;
-				}
-			}
-			else
-			{
-				// if we've fallen through to here, it means that we're
-				// neither too far to the left or too far to the right
-				// of the vertical center line of the image and don't 
-				// need to move the servo
-				servo_step = 0;
-				letMyAimBeTrue = 1;
-			}
-/*
-			// add the step to the current servo position, taking into
-			// account the direction set by the user in tracking.h
-			temp_pan_servo += ((int)Tracking_Config_Data.Pan_Rotation_Sign * servo_step);
-
-			// check the pan servo PWM value for under/overflow
-			if(temp_pan_servo < (int)Tracking_Config_Data.Pan_Min_PWM)
-			{
-				temp_pan_servo = (int)Tracking_Config_Data.Pan_Min_PWM;
-			}
-			else if(temp_pan_servo > (int)Tracking_Config_Data.Pan_Max_PWM)
+			pan_error = (int)t_packet.mx - (int)Tracking_Config_Data.Pan_Target_Pixel;
+
+			// publish the errors and confidence; the errors are
+			// also where the search starts if we lose the target
+			Tracking_State.State = TRACKING_NOT_AIMED;
+			Tracking_State.Pan_Error = pan_error;
+			Tracking_State.Confidence = t_packet.confidence;
+
+			// Are we close enough to the vertical center line to
+			// call the turret aimed? If so, clear the integral, so
+			// that the turret doesn't creep out of the deadband and
+			// hunt back and forth over the last few pixels, but keep
+			// turning it against the robot's rotation. Otherwise,
+			// update the turret motor command.
+			if(pan_error <= (int)Tracking_Config_Data.Pan_Allowable_Error &&
+			   pan_error >= -1 * (int)Tracking_Config_Data.Pan_Allowable_Error)
 			{
-				temp_pan_servo = (int)Tracking_Config_Data.Pan_Max_PWM;
-			}
-
-			// update pan servo PWM value
-			PAN_SERVO = (unsigned char)temp_pan_servo;
-
-*/
-
-/*
-			// Move the turret motor in the direction of the error
-			if (servo_step > 0)
-			{
-				temp_pan_servo = (127 + ((int)Tracking_Config_Data.Pan_Rotation_Sign * turnVelocity)); 
-			}
-			else if (servo_step < 0)
-			{
-				temp_pan_servo = (127 - ((int)Tracking_Config_Data.Pan_Rotation_Sign * turnVelocity));
+				Tracking_State.State = TRACKING_AIMED;
+				PAN_SERVO = (unsigned char)Pan_Hold(t_packet.mx, Get_Yaw_Rate());
 			}
 			else
 			{
-				temp_pan_servo = 127;
-				letMyAimBeTrue = 1;
+				PAN_SERVO = (unsigned char)Pan_Controller(pan_error, t_packet.mx, Get_Yaw_Rate());
 			}
-*/
-
-			temp_pan_servo = 127 + (((int)Tracking_Config_Data.Pan_Rotation_Sign )* (velocityToStart + servo_step) + driveDifferential);
-			
-			PAN_SERVO = (unsigned char)temp_pan_servo;
 
 
 			/////////////////////////////////
@@ -258,7 +203,8 @@ int Servo_Track(int driveR, int driveL)
 
 			// calculate how many image pixels we're away from the
 			// horizontal center line.
-			tilt_error = (int)T_Packet_Data.my - (int)Tracking_Config_Data.Tilt_Target_Pixel;
+			tilt_error = (int)t_packet.my - (int)Tracking_Config_Data.Tilt_Target_Pixel;
+			Tracking_State.Tilt_Error = tilt_error;
 
 			// Are we too far above or below the horizontal center line?
 			// If so, calculate how far we should step the tilt servo to 
@@ -318,38 +264,6 @@ int Servo_Track(int driveR, int driveL)
 //			printf("Updating tilt PWM value in tracking\n");
 			// update tilt servo PWM value
 			TILT_SERVO = (unsigned char)temp_tilt_servo;
-			/*
-			// Update hood angle based on tilt pwm value
-			if (((temp_tilt_servo - 30) < 40) && ((temp_tilt_servo - 30) > 13))
-			{
-				pwm11 = hood_angle[temp_tilt_servo - 40] + 120;
-				pwm12 = 254 - hood_angle[temp_tilt_servo - 40] + 120;
-			}
-			else
-			{
-				pwm11 = 127;
-				pwm12 = 127;
-			}
-
-			*/
-/*
-			//printf("\nCalculating Hood Position\n");
-			if ((127 - temp_tilt_servo) < 0)
-				position = 254 + (127 - temp_tilt_servo);
-			else if ((127 - temp_tilt_servo) > 254)
-				position = (127 - temp_tilt_servo) - 254;
-			else
-				position = (127 - temp_tilt_servo);
-			
-			if (((position - 30 - 66) < 40) && ((position - 30 - 66) > 13))
-			{
-					pwm11 = hood_angle[position - 66 - 10];
-					pwm12 = 254 - hood_angle[position - 66 - 10];
-			}
-			else
-				pwm11 = pwm12 = 127;
-			
-*/
 
 		}
 		else
@@ -359,92 +273,565 @@ int Servo_Track(int driveR, int driveL)
 			//  search code  //
 			//               //
 			///////////////////
-			letMyAimBeTrue = 300;
-			// To provide a delay for the camera to lock onto the
-			// target between position changes, we only step the camera
-			// to a new position every SEARCH_DELAY times while we're 
-			// in search mode. SEARCH_DELAY is #define'd in tracking.h
-			loop_count++;
-
-			if(loop_count > 12)
+			Tracking_State.State = TRACKING_SEARCHING;
+			Tracking_State.Lock_Age = 0;
+			Tracking_State.Confidence = t_packet.confidence;
+
+			// start the pan controller over when we find the target again
+			Reset_Pan_Controller();
+
+			// If we've just lost the target, plan a new search
+			// starting from where it was last seen. Otherwise,
+			// just continue the search pattern from where we left
+			// off. The variable new_search is reset to one each
+			// time the tracking code (above) executes.
+			if(new_search == 1)
 			{
-				// reset the loop counter
-				loop_count = 0;
-
-				// If we're starting a new search, initialize the pan
-				// and tilt servos to the search starting point.
-				// Otherwise, just continue the search pattern from
-				// where we left off. The variable new_search is reset
-				// to one each time the tracking code (above) executes.
-				if(new_search == 1)
-				{
-					new_search = 0;
-					//temp_pan_servo = 0;
-					temp_tilt_servo = Tracking_Config_Data.Tilt_Center_PWM;
-										
-				}
-				else
+				new_search = 0;
+				Start_Search(Get_Yaw_Rate());
+			}
+		}
+	}
+
+	// The search pattern runs every slow loop, not just when a
+	// T packet arrives, so that its steps take the same time
+	// however fast the camera is sending.
+	if(Tracking_State.State == TRACKING_SEARCHING && new_search == 0)
+	{
+		PAN_SERVO = (unsigned char)Search_Step(Get_Yaw_Rate());
+	}
+
+	// count how long the camera has had the target
+	if(Tracking_State.State != TRACKING_SEARCHING && Tracking_State.Lock_Age < 0xFFFF)
+	{
+		Tracking_State.Lock_Age++;
+	}
+
+	// estimate the range to the target from the newest
+	// T packet and the tilt angle it was taken at
+	Range_Update();
+	Tracking_State.Range = Range_Estimate;
+	Tracking_State.Range_Valid = range_valid;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Tracking_Shot_Ready()
+*
+*	PURPOSE:		Decides whether the turret has a shot.
+*
+*	CALLED FROM:	user_routines.c/Process_Data_From_Master_uP(),
+*					user_routines_fast.c/User_Autonomous_Code()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		1 if the turret is aimed, has held the target for at
+*					least TRACKING_SHOT_MIN_LOCK_AGE slow loops and the
+*					target is within shooting range, 0 otherwise.
+*
+*	COMMENTS:		Reads Tracking_State, so call it after Servo_Track().
+*
+*******************************************************************************/
+unsigned char Tracking_Shot_Ready(void)
+{
+	if(Tracking_State.State == TRACKING_AIMED &&
+	   Tracking_State.Lock_Age >= TRACKING_SHOT_MIN_LOCK_AGE &&
+	   Range_In_Shot_Window() == 1)
+	{
+		return(1);
+	}
+	else
+	{
+		return(0);
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Pan_Controller()
+*
+*	PURPOSE:		Calculates the turret motor command from the pan error.
+*
+*	CALLED FROM:	Servo_Track(), above.
+*
+*	PARAMETERS:		Pan error in pixels, the target's x position in the
+*					image (T packet mx) and the robot's yaw rate in degrees
+*					per second.
+*
+*	RETURNS:		Turret motor PWM command, limited to Pan_Min_PWM
+*					through Pan_Max_PWM.
+*
+*	COMMENTS:		This is a PID controller with a feed-forward term, all
+*					in integer math with gains in sixteenths. There are no
+*					loops, so every call takes about the same time.
+*
+*					The derivative term is taken on the target position
+*					rather than the error, so a change in Pan_Target_Pixel
+*					doesn't kick the turret.
+*
+*					The integral is clamped to Pan_Integral_Limit PWM
+*					counts and isn't allowed to grow while the output is
+*					limited, so it can't wind up while the turret is
+*					already turning as fast as it's allowed to.
+*
+*					The feed-forward term turns the turret against the
+*					robot's rotation (see yaw.c) before the camera sees
+*					any error.
+*
+*******************************************************************************/
+int Pan_Controller(int pan_error, unsigned char mx, int yaw_rate)
+{
+	long integral;
+	long integral_limit;
+	long output;
+	int derivative;
+	unsigned char limited;
+
+	// The error is the target position less a constant, so
+	// the derivative of the target position is the derivative
+	// of the error. It needs two samples.
+	if(pan_controller_primed == 1)
+	{
+		derivative = (int)mx - (int)pan_last_mx;
+	}
+	else
+	{
+		derivative = 0;
+		pan_controller_primed = 1;
+	}
+	pan_last_mx = mx;
+
+	// integrate the error and clamp the result
+	integral_limit = (long)Tracking_Config_Data.Pan_Integral_Limit * 16L;
+
+	integral = pan_integral + (long)Tracking_Config_Data.Pan_Ki * (long)pan_error;
+
+	if(integral > integral_limit)
+	{
+		integral = integral_limit;
+	}
+	else if(integral < -integral_limit)
+	{
+		integral = -integral_limit;
+	}
+
+	// Sum the terms, in sixteenths of a PWM count. A counter-
+	// clockwise turn moves the target to the right in the image,
+	// the same as a positive error, so the yaw rate is added.
+	output = (long)Tracking_Config_Data.Pan_Kp * (long)pan_error
+		+ integral
+		+ (long)Tracking_Config_Data.Pan_Kd * (long)derivative
+		+ (long)Tracking_Config_Data.Pan_Kff * (long)yaw_rate;
+
+	// convert to a PWM command, taking into account the
+	// direction set by the user in tracking.h
+	output = 127L + (long)Tracking_Config_Data.Pan_Rotation_Sign * (output / 16L);
+
+	// check the PWM command for under/overflow
+	limited = 0;
+
+	if(output < (long)Tracking_Config_Data.Pan_Min_PWM)
+	{
+		output = (long)Tracking_Config_Data.Pan_Min_PWM;
+		limited = 1;
+	}
+	else if(output > (long)Tracking_Config_Data.Pan_Max_PWM)
+	{
+		output = (long)Tracking_Config_Data.Pan_Max_PWM;
+		limited = 1;
+	}
+
+	// only keep the new integral if the output isn't limited
+	if(limited == 0)
+	{
+		pan_integral = integral;
+	}
+
+	return((int)output);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Pan_Hold()
+*
+*	PURPOSE:		Calculates the turret motor command while the turret
+*					is aimed.
+*
+*	CALLED FROM:	Servo_Track(), above.
+*
+*	PARAMETERS:		The target's x position in the image (T packet mx)
+*					and the robot's yaw rate in degrees per second.
+*
+*	RETURNS:		Turret motor PWM command, limited to Pan_Min_PWM
+*					through Pan_Max_PWM.
+*
+*	COMMENTS:		Only the feed-forward term of Pan_Controller() is
+*					used, so the turret stands still while the robot does
+*					and counters the robot's rotation while it turns.
+*
+*					The integral is cleared, but the target position is
+*					kept so that Pan_Controller()'s derivative term is
+*					good as soon as the target leaves the deadband.
+*
+*******************************************************************************/
+int Pan_Hold(unsigned char mx, int yaw_rate)
+{
+	long output;
+
+	pan_integral = 0;
+	pan_last_mx = mx;
+	pan_controller_primed = 1;
+
+	// feed-forward term, in sixteenths of a PWM count
+	output = (long)Tracking_Config_Data.Pan_Kff * (long)yaw_rate;
+
+	// convert to a PWM command, taking into account the
+	// direction set by the user in tracking.h
+	output = 127L + (long)Tracking_Config_Data.Pan_Rotation_Sign * (output / 16L);
+
+	// check the PWM command for under/overflow
+	if(output < (long)Tracking_Config_Data.Pan_Min_PWM)
+	{
+		output = (long)Tracking_Config_Data.Pan_Min_PWM;
+	}
+	else if(output > (long)Tracking_Config_Data.Pan_Max_PWM)
+	{
+		output = (long)Tracking_Config_Data.Pan_Max_PWM;
+	}
+
+	return((int)output);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Reset_Pan_Controller()
+*
+*	PURPOSE:		Clears the pan controller's integral and derivative
+*					history.
+*
+*	CALLED FROM:	Servo_Track() and Initialize_Tracking(), both in this
+*					file.
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Call this when the target is lost, so that the
+*					controller doesn't act on stale data when it next
+*					runs.
+*
+*******************************************************************************/
+void Reset_Pan_Controller(void)
+{
+	pan_integral = 0;
+	pan_controller_primed = 0;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Turret_Estimate_Update()
+*
+*	PURPOSE:		Moves the estimate of where the turret is pointed on
+*					by one slow loop.
+*
+*	CALLED FROM:	Servo_Track(), above.
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The turret is taken to have turned at TURRET_RATE times
+*					the command sent in the last frame for the whole frame.
+*					That includes the operator's override and the slew
+*					limit (see slew.c). The error builds up the longer the
+*					turret runs, but running it into a stop takes the
+*					estimate there too, since the estimate isn't allowed
+*					past TURRET_TRAVEL.
+*
+*******************************************************************************/
+static void Turret_Estimate_Update(void)
+{
+	int speed;
+
+	// speed in the same direction as a positive pan error
+	speed = (int)Tracking_Config_Data.Pan_Rotation_Sign * ((int)Get_Last_Pan() - 127);
+
+	if(speed > TURRET_MAX_SPEED)
+	{
+		speed = TURRET_MAX_SPEED;
+	}
+	else if(speed < -TURRET_MAX_SPEED)
+	{
+		speed = -TURRET_MAX_SPEED;
+	}
+
+	turret_estimate += speed * TURRET_RATE;
+
+	if(turret_estimate > TURRET_TRAVEL * 100)
+	{
+		turret_estimate = TURRET_TRAVEL * 100;
+	}
+	else if(turret_estimate < -TURRET_TRAVEL * 100)
+	{
+		turret_estimate = -TURRET_TRAVEL * 100;
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Start_Search()
+*
+*	PURPOSE:		Plans a new search pattern after the target is lost.
+*
+*	CALLED FROM:	Servo_Track(), above.
+*
+*	PARAMETERS:		The robot's yaw rate in degrees per second.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The pattern is centered where the turret and tilt
+*					servo are when the target is lost, or SEARCH_PAN_LIMIT
+*					degrees from straight ahead if the turret is farther
+*					out than that. The first pan leg heads the way the
+*					target most likely went: the way the robot's turn
+*					moved it if the robot is turning, otherwise toward the
+*					side of the image it was last seen on. The first tilt
+*					leg heads toward the edge of the image the target was
+*					last seen nearest.
+*
+*******************************************************************************/
+static void Start_Search(int yaw_rate)
+{
+	// A counter-clockwise turn moves the target to the right
+	// in the image, the same as a positive pan error.
+	if(yaw_rate >= SEARCH_MIN_YAW_RATE)
+	{
+		search_pan_direction = 1;
+	}
+	else if(yaw_rate <= -SEARCH_MIN_YAW_RATE)
+	{
+		search_pan_direction = -1;
+	}
+	else if(Tracking_State.Pan_Error < 0)
+	{
+		search_pan_direction = -1;
+	}
+	else
+	{
+		search_pan_direction = 1;
+	}
+
+	// the tracking code steps the tilt servo by Tilt_Rotation_Sign
+	// times the tilt error, so do the same here
+	if(Tracking_State.Tilt_Error < 0)
+	{
+		search_tilt_direction = -1 * Tracking_Config_Data.Tilt_Rotation_Sign;
+	}
+	else
+	{
+		search_tilt_direction = Tracking_Config_Data.Tilt_Rotation_Sign;
+	}
+
+	search_pan_center = turret_estimate;
+
+	if(search_pan_center > SEARCH_PAN_LIMIT * 100)
+	{
+		search_pan_center = SEARCH_PAN_LIMIT * 100;
+	}
+	else if(search_pan_center < -SEARCH_PAN_LIMIT * 100)
+	{
+		search_pan_center = -SEARCH_PAN_LIMIT * 100;
+	}
+
+	search_tilt_target = (int)TILT_SERVO;
+	search_timer = 0;
+	search_leg_length = 1;
+	search_leg_steps = 0;
+	search_pan_leg = 1;
+	search_returning = 0;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Search_Step()
+*
+*	PURPOSE:		Runs the search pattern planned by Start_Search().
+*
+*	CALLED FROM:	Servo_Track(), above.
+*
+*	PARAMETERS:		The robot's yaw rate in degrees per second.
+*
+*	RETURNS:		Turret motor PWM command, limited to Pan_Min_PWM
+*					through Pan_Max_PWM.
+*
+*	COMMENTS:		Call once per slow loop. Each step of the pattern
+*					lasts Search_Delay slow loops. The tilt servo target
+*					moves at the start of each step of a tilt leg, and the
+*					turret motor runs at SEARCH_PAN_SPEED through each step
+*					of a pan leg. The tilt target is written every time,
+*					so the tilt servo gets there even when its slew rate
+*					is limited (see slew.c).
+*
+*					The pan legs alternate direction and grow by a step
+*					each time, so a pattern doesn't end where it started.
+*					Once the legs grow longer than SEARCH_MAX_LEG, the
+*					turret runs back to where the pattern started, going
+*					by the turret estimate, before the pattern starts
+*					over, so the turret doesn't wander off to one side
+*					during a long search.
+*
+*					A pan leg that reaches SEARCH_PAN_LIMIT ends there,
+*					and the turret is never turned past it, so the
+*					pattern can't run the turret into its stops.
+*
+*					The turret is also turned against the robot's
+*					rotation the same way Pan_Controller() does it, and
+*					the center of the pattern is moved with it, so the
+*					pattern stays centered where the target was lost
+*					while the robot turns.
+*
+*******************************************************************************/
+static int Search_Step(int yaw_rate)
+{
+	int feed_forward;
+	int speed;
+
+	// feed-forward term, in PWM counts
+	feed_forward = (int)(((long)Tracking_Config_Data.Pan_Kff * (long)yaw_rate) / 16L);
+
+	// keep the pattern centered on the same bearing
+	search_pan_center += feed_forward * TURRET_RATE;
+
+	if(search_pan_center > SEARCH_PAN_LIMIT * 100)
+	{
+		search_pan_center = SEARCH_PAN_LIMIT * 100;
+	}
+	else if(search_pan_center < -SEARCH_PAN_LIMIT * 100)
+	{
+		search_pan_center = -SEARCH_PAN_LIMIT * 100;
+	}
+
+	search_timer++;
+
+	if(search_returning == 1)
+	{
+		// back where the pattern started? If so, start over.
+		if((search_pan_direction > 0 && turret_estimate >= search_pan_center) ||
+		   (search_pan_direction < 0 && turret_estimate <= search_pan_center))
+		{
+			search_returning = 0;
+			search_timer = 0;
+			search_leg_length = 1;
+			search_leg_steps = 0;
+		}
+	}
+	else if(search_pan_leg == 1 &&
+			((search_pan_direction > 0 && turret_estimate >= SEARCH_PAN_LIMIT * 100) ||
+			 (search_pan_direction < 0 && turret_estimate <= -SEARCH_PAN_LIMIT * 100)))
+	{
+		// cut this pan leg short and go on to the tilt leg
+		search_timer = 0;
+		search_leg_steps = 0;
+		search_pan_leg = 0;
+	}
+	// time for the next step?
+	else if(search_timer >= Tracking_Config_Data.Search_Delay)
+	{
+		search_timer = 0;
+		search_leg_steps++;
+
+		// end of this leg?
+		if(search_leg_steps >= search_leg_length)
+		{
+			search_leg_steps = 0;
+
+			if(search_pan_leg == 1)
+			{
+				// a tilt leg of the same length follows a pan leg
+				search_pan_leg = 0;
+			}
+			else
+			{
+				// the next pan and tilt legs are one step longer
+				// and go the other way
+				search_pan_leg = 1;
+				search_pan_direction = -1 * search_pan_direction;
+				search_tilt_direction = -1 * search_tilt_direction;
+				search_leg_length++;
+
+				// once the legs get too long, run the turret back
+				// to where the pattern started
+				if(search_leg_length > SEARCH_MAX_LEG)
 				{
-					if (loop_count <= 8)
+					search_leg_length = 1;
+
+					if(turret_estimate < search_pan_center)
 					{
-						//temp_pan_servo = 157;
-						loop_count++;
+						search_pan_direction = 1;
+						search_returning = 1;
 					}
-				
-					else
+					else if(turret_estimate > search_pan_center)
 					{
-						temp_pan_servo = 127;
-						loop_count++;
-					}	
-// calculate new servo position(s) based upon our
-					// current servo position(s)
-					temp_tilt_servo = (int)TILT_SERVO;
-	
-					// if the pan servo is at the end of its travel, 
-					// send it back to the start and step the tilt
-					// servo to its next position
-
-		
-						// if the tilt servo is at the end of its
-						// travel, send it back to the start
-						if(temp_tilt_servo >= (int)Tracking_Config_Data.Tilt_Max_PWM)
-						{
-							temp_tilt_servo = (int)Tracking_Config_Data.Tilt_Min_PWM;
-						}
-						else
-						{
-							// step the tilt servo to its next destination
-							temp_tilt_servo += (int)Tracking_Config_Data.Tilt_Search_Step_Size;
-			
-							// make sure its new position isn't beyond
-							// the maximum value set in tracking.h
-							if(temp_tilt_servo >= (int)Tracking_Config_Data.Tilt_Max_PWM)
-							{
-								temp_tilt_servo = (int)Tracking_Config_Data.Tilt_Max_PWM;
-						}	}
-						
-					
-
-					
+						search_pan_direction = -1;
+						search_returning = 1;
+					}
 				}
+			}
+		}
 
+		// step the tilt servo target if this is a tilt leg
+		if(search_pan_leg == 0)
+		{
+			search_tilt_target +=
+				(int)search_tilt_direction * (int)Tracking_Config_Data.Tilt_Search_Step_Size;
 
-					
-				// update the pan and tilt servo PWM value
-				pwm09 = 127;
-				TILT_SERVO = (unsigned char)temp_tilt_servo;
-
+			// at the end of its travel, the tilt servo turns back
+			if(search_tilt_target <= (int)Tracking_Config_Data.Tilt_Min_PWM)
+			{
+				search_tilt_target = (int)Tracking_Config_Data.Tilt_Min_PWM;
+				search_tilt_direction = 1;
 			}
+			else if(search_tilt_target >= (int)Tracking_Config_Data.Tilt_Max_PWM)
+			{
+				search_tilt_target = (int)Tracking_Config_Data.Tilt_Max_PWM;
+				search_tilt_direction = -1;
+			}
+		}
+	}
 
+	TILT_SERVO = (unsigned char)search_tilt_target;
 
-		}
+	// turret speed, in PWM counts in the direction of a positive
+	// pan error
+	speed = feed_forward;
+
+	if(search_pan_leg == 1)
+	{
+		speed += (int)search_pan_direction * SEARCH_PAN_SPEED;
 	}
-	if (letMyAimBeTrue == 1)
-		return temp_tilt_servo;
-	else if (letMyAimBeTrue == 300)
-		return letMyAimBeTrue;
-	else
-		return 0;
+
+	// don't turn the turret past the search limit
+	if((speed > 0 && turret_estimate >= SEARCH_PAN_LIMIT * 100) ||
+	   (speed < 0 && turret_estimate <= -SEARCH_PAN_LIMIT * 100))
+	{
+		speed = 0;
+	}
+
+	// convert to a PWM command, taking into account the
+	// direction set by the user in tracking.h
+	speed = 127 + (int)Tracking_Config_Data.Pan_Rotation_Sign * speed;
+
+	// check the PWM command for under/overflow
+	if(speed < (int)Tracking_Config_Data.Pan_Min_PWM)
+	{
+		speed = (int)Tracking_Config_Data.Pan_Min_PWM;
+	}
+	else if(speed > (int)Tracking_Config_Data.Pan_Max_PWM)
+	{
+		speed = (int)Tracking_Config_Data.Pan_Max_PWM;
+	}
+
+	return(speed);
 }
 
 /*******************************************************************************
@@ -472,6 +859,9 @@ void Initialize_Tracking(void)
 	// load tracking configuration structure
 	returned_value = Get_Tracking_Configuration(TRACKING_CONFIG_EEPROM_ADDRESS, 0);
 
+	// start the pan controller from scratch
+	Reset_Pan_Controller();
+
 	// if debugging mode is on, report where the tracking configuration 
 	// data came from (DEBUG() is a macro defined in camera.h)
 	if(returned_value == TRACKING_EEPROM_USED)
@@ -603,6 +993,11 @@ unsigned char Get_Tracking_Configuration(unsigned int eeprom_address, unsigned c
 		Tracking_Config_Data.Tilt_Search_Step_Size = TILT_SEARCH_STEP_SIZE_DEFAULT;
 		Tracking_Config_Data.Tilt_Target_Pixel = TILT_TARGET_PIXEL_DEFAULT;
 		Tracking_Config_Data.Search_Delay = SEARCH_DELAY_DEFAULT;
+		Tracking_Config_Data.Pan_Kp = PAN_KP_DEFAULT;
+		Tracking_Config_Data.Pan_Ki = PAN_KI_DEFAULT;
+		Tracking_Config_Data.Pan_Kd = PAN_KD_DEFAULT;
+		Tracking_Config_Data.Pan_Kff = PAN_KFF_DEFAULT;
+		Tracking_Config_Data.Pan_Integral_Limit = PAN_INTEGRAL_LIMIT_DEFAULT;
 	}
 	return(return_value);
 }
@@ -50,13 +50,63 @@
 // camera to lock onto the target between position changes.
 #define SEARCH_DELAY_DEFAULT 5
 
+// Turret motor speed, in PWM counts from neutral, used on the
+// pan legs of the search pattern
+#define SEARCH_PAN_SPEED 20
+
+// Once the legs of the search pattern grow longer than this many
+// steps, the turret runs back to where the pattern started and the
+// pattern starts over
+#define SEARCH_MAX_LEG 6
+
+// The search pattern doesn't take the turret farther than this many
+// degrees to either side of straight ahead
+#define SEARCH_PAN_LIMIT 120
+
+// If the robot is turning at least this fast (degrees per second)
+// when the target is lost, the search starts off in the direction
+// the turn moved the target. Otherwise it starts off toward the
+// side of the image the target was last seen on.
+#define SEARCH_MIN_YAW_RATE 10
+
+// There's no sensor on the turret, so the tracking code estimates
+// where it's pointed from the commands sent to it. This is the turret
+// speed, in hundredths of a degree per slow loop, for each PWM count
+// the command is away from neutral. Calibrate by running the turret
+// at a known command and timing it across its travel.
+#define TURRET_RATE 4
+
+// Turret commands farther than this from neutral don't turn the
+// turret any faster
+#define TURRET_MAX_SPEED 80
+
+// Degrees from straight ahead to the turret's mechanical stops. The
+// estimate is held within them. The turret must be straight ahead at
+// power up.
+#define TURRET_TRAVEL 150
+
 // These values define how quickly the camera will attempt 
 // to track the object. If these are set too high, the camera 
 // will take longer to settle, too low and the camera will
-// overshoot the target and oscillate.
+// overshoot the target and oscillate. The pan gain is no
+// longer used; see Tracking_Config_Data_Type.
 #define PAN_GAIN_DEFAULT 1
 #define TILT_GAIN_DEFAULT 8
 
+// Gains of the pan (turret) controller, in sixteenths. The
+// integral term is clamped to +/-PAN_INTEGRAL_LIMIT_DEFAULT
+// PWM counts so that it can't wind up while the turret is
+// saturated or the target is out of reach. The feed-forward
+// gain scales the robot's yaw rate in degrees per second (see
+// yaw.c) into a turret command that counters the rotation.
+// If the turret turns with the robot instead of against it,
+// change the sign of the feed-forward gain.
+#define PAN_KP_DEFAULT 16
+#define PAN_KI_DEFAULT 1
+#define PAN_KD_DEFAULT 8
+#define PAN_KFF_DEFAULT 4
+#define PAN_INTEGRAL_LIMIT_DEFAULT 24
+
 // If your camera suddenly moves away from the target once
 // it finds it, you'll need to change the sign on one or
 // both of these values.
@@ -88,7 +138,8 @@
 // This value defines how far the pan servo will step
 // each time while in search mode. This value was chosen
 // to provide five evenly spaced stopping points (i.e., 0,
-// 62, 124, 186 and 248) for the pan servo.
+// 62, 124, 186 and 248) for the pan servo. It is no longer
+// used; see Tracking_Config_Data_Type.
 #define PAN_SEARCH_STEP_SIZE_DEFAULT 62
 
 // These values define the PWM values of the pan and tilt
@@ -112,6 +163,15 @@
 #define IMAGE_WIDTH 159
 #define IMAGE_HEIGHT 239
 
+// Tracking_State.State values
+#define TRACKING_NOT_AIMED 0	// target in view, turret not on it yet
+#define TRACKING_AIMED 1		// turret pointed at the target
+#define TRACKING_SEARCHING 2	// target lost; search pattern running
+
+// Tracking_Shot_Ready() won't report a shot until the camera has
+// had the target for at least this many slow loops
+#define TRACKING_SHOT_MIN_LOCK_AGE 2
+
 // Get_Tracking_Configuration() return values
 #define TRACKING_EEPROM_USED 0
 #define TRACKING_EEPROM_CORRUPT 1
@@ -127,10 +187,10 @@ typedef struct
 	unsigned char Pan_Min_PWM;			//
 	unsigned char Pan_Center_PWM;		//
 	unsigned char Pan_Max_PWM;			//
-	unsigned char Pan_Gain;				//
+	unsigned char Pan_Gain;				// reserved, see below
 	unsigned char Pan_Allowable_Error;	//
 	         char Pan_Rotation_Sign;	//
-	unsigned char Pan_Search_Step_Size;	//
+	unsigned char Pan_Search_Step_Size;	// reserved, see below
 	unsigned char Pan_Target_Pixel;		//
 	unsigned char Tilt_Min_PWM;			//
 	unsigned char Tilt_Center_PWM;		//
@@ -141,14 +201,44 @@ typedef struct
 	unsigned char Tilt_Search_Step_Size;//
 	unsigned char Tilt_Target_Pixel;	//
 	unsigned char Search_Delay;			//
+	unsigned char Pan_Kp;				// proportional gain, sixteenths
+	unsigned char Pan_Ki;				// integral gain, sixteenths
+	unsigned char Pan_Kd;				// derivative gain, sixteenths
+	         char Pan_Kff;				// feed-forward gain, sixteenths
+	unsigned char Pan_Integral_Limit;	// integral clamp, PWM counts
 	unsigned char Checksum;				// eight-bit structure checksum
 }	Tracking_Config_Data_Type;
+// Pan_Gain and Pan_Search_Step_Size date from when the turret was
+// a position servo. Nothing reads them now that the Pan_Kx gains
+// drive it and the search pattern runs at SEARCH_PAN_SPEED, but
+// they're kept so that configurations already saved to EEPROM
+// still line up with this structure.
+
+// this defines the tracking state structure that Servo_Track()
+// updates once per slow loop for the rest of the code to read
+typedef struct
+{
+	unsigned char State;		// TRACKING_NOT_AIMED, TRACKING_AIMED or
+								// TRACKING_SEARCHING
+	int Pan_Error;				// pixels from Pan_Target_Pixel and
+	int Tilt_Error;				// Tilt_Target_Pixel in the last T packet
+								// with the target in it
+	unsigned int Lock_Age;		// slow loops the camera has had the target
+	unsigned char Confidence;	// T packet confidence
+	unsigned int Range;			// range to the target in inches
+	unsigned char Range_Valid;	// one if Range is current
+}	Tracking_State_Type;
 
 // global variables
 extern Tracking_Config_Data_Type Tracking_Config_Data;
+extern Tracking_State_Type Tracking_State;
 
 // function prototypes
-int Servo_Track(int driveR, int driveL);
+void Servo_Track(int driveR, int driveL);
+unsigned char Tracking_Shot_Ready(void);
+void Reset_Pan_Controller(void);
+int Pan_Controller(int, unsigned char, int);
+int Pan_Hold(unsigned char, int);
 void Initialize_Tracking(void);
 unsigned char Get_Tracking_Configuration(unsigned int, unsigned char);
 
@@ -17,6 +17,7 @@
 #include "ifi_default.h"
 #include "ifi_utilities.h"
 #include "user_routines.h"
+#include "sim.h"
 #include "serial_ports.h"
 #include "camera.h"
 #include "camera_menu.h"
@@ -24,6 +25,11 @@
 #include "tracking_menu.h"
 #include "eeprom.h"
 #include "terminal.h"
+#include "profile.h"
+#include "drive_curves.h"
+#include "hood.h"
+#include "yaw.h"
+#include "slew.h"
 #include <math.h>
 
 
@@ -112,6 +118,71 @@ unsigned char Limit_Mix (int intermediate_value)
 }
 
 
+/* Cubic joystick response curve, (x - 127)^3 / 16129 + 127, rounded down.
+   Expanded at compile time; the result runs from 0 to 257. */
+#define JOYSTICK_CUBIC(x) ((unsigned int)(((long)((x) - 127) * ((x) - 127) * ((x) - 127) + 127L * 16129L) / 16129L))
+
+rom const unsigned int Joystick_Cubic_Table[256] =
+{
+  JOYSTICK_CUBIC(0), JOYSTICK_CUBIC(1), JOYSTICK_CUBIC(2), JOYSTICK_CUBIC(3), JOYSTICK_CUBIC(4), JOYSTICK_CUBIC(5), JOYSTICK_CUBIC(6), JOYSTICK_CUBIC(7),
+  JOYSTICK_CUBIC(8), JOYSTICK_CUBIC(9), JOYSTICK_CUBIC(10), JOYSTICK_CUBIC(11), JOYSTICK_CUBIC(12), JOYSTICK_CUBIC(13), JOYSTICK_CUBIC(14), JOYSTICK_CUBIC(15),
+  JOYSTICK_CUBIC(16), JOYSTICK_CUBIC(17), JOYSTICK_CUBIC(18), JOYSTICK_CUBIC(19), JOYSTICK_CUBIC(20), JOYSTICK_CUBIC(21), JOYSTICK_CUBIC(22), JOYSTICK_CUBIC(23),
+  JOYSTICK_CUBIC(24), JOYSTICK_CUBIC(25), JOYSTICK_CUBIC(26), JOYSTICK_CUBIC(27), JOYSTICK_CUBIC(28), JOYSTICK_CUBIC(29), JOYSTICK_CUBIC(30), JOYSTICK_CUBIC(31),
+  JOYSTICK_CUBIC(32), JOYSTICK_CUBIC(33), JOYSTICK_CUBIC(34), JOYSTICK_CUBIC(35), JOYSTICK_CUBIC(36), JOYSTICK_CUBIC(37), JOYSTICK_CUBIC(38), JOYSTICK_CUBIC(39),
+  JOYSTICK_CUBIC(40), JOYSTICK_CUBIC(41), JOYSTICK_CUBIC(42), JOYSTICK_CUBIC(43), JOYSTICK_CUBIC(44), JOYSTICK_CUBIC(45), JOYSTICK_CUBIC(46), JOYSTICK_CUBIC(47),
+  JOYSTICK_CUBIC(48), JOYSTICK_CUBIC(49), JOYSTICK_CUBIC(50), JOYSTICK_CUBIC(51), JOYSTICK_CUBIC(52), JOYSTICK_CUBIC(53), JOYSTICK_CUBIC(54), JOYSTICK_CUBIC(55),
+  JOYSTICK_CUBIC(56), JOYSTICK_CUBIC(57), JOYSTICK_CUBIC(58), JOYSTICK_CUBIC(59), JOYSTICK_CUBIC(60), JOYSTICK_CUBIC(61), JOYSTICK_CUBIC(62), JOYSTICK_CUBIC(63),
+  JOYSTICK_CUBIC(64), JOYSTICK_CUBIC(65), JOYSTICK_CUBIC(66), JOYSTICK_CUBIC(67), JOYSTICK_CUBIC(68), JOYSTICK_CUBIC(69), JOYSTICK_CUBIC(70), JOYSTICK_CUBIC(71),
+  JOYSTICK_CUBIC(72), JOYSTICK_CUBIC(73), JOYSTICK_CUBIC(74), JOYSTICK_CUBIC(75), JOYSTICK_CUBIC(76), JOYSTICK_CUBIC(77), JOYSTICK_CUBIC(78), JOYSTICK_CUBIC(79),
+  JOYSTICK_CUBIC(80), JOYSTICK_CUBIC(81), JOYSTICK_CUBIC(82), JOYSTICK_CUBIC(83), JOYSTICK_CUBIC(84), JOYSTICK_CUBIC(85), JOYSTICK_CUBIC(86), JOYSTICK_CUBIC(87),
+  JOYSTICK_CUBIC(88), JOYSTICK_CUBIC(89), JOYSTICK_CUBIC(90), JOYSTICK_CUBIC(91), JOYSTICK_CUBIC(92), JOYSTICK_CUBIC(93), JOYSTICK_CUBIC(94), JOYSTICK_CUBIC(95),
+  JOYSTICK_CUBIC(96), JOYSTICK_CUBIC(97), JOYSTICK_CUBIC(98), JOYSTICK_CUBIC(99), JOYSTICK_CUBIC(100), JOYSTICK_CUBIC(101), JOYSTICK_CUBIC(102), JOYSTICK_CUBIC(103),
+  JOYSTICK_CUBIC(104), JOYSTICK_CUBIC(105), JOYSTICK_CUBIC(106), JOYSTICK_CUBIC(107), JOYSTICK_CUBIC(108), JOYSTICK_CUBIC(109), JOYSTICK_CUBIC(110), JOYSTICK_CUBIC(111),
+  JOYSTICK_CUBIC(112), JOYSTICK_CUBIC(113), JOYSTICK_CUBIC(114), JOYSTICK_CUBIC(115), JOYSTICK_CUBIC(116), JOYSTICK_CUBIC(117), JOYSTICK_CUBIC(118), JOYSTICK_CUBIC(119),
+  JOYSTICK_CUBIC(120), JOYSTICK_CUBIC(121), JOYSTICK_CUBIC(122), JOYSTICK_CUBIC(123), JOYSTICK_CUBIC(124), JOYSTICK_CUBIC(125), JOYSTICK_CUBIC(126), JOYSTICK_CUBIC(127),
+  JOYSTICK_CUBIC(128), JOYSTICK_CUBIC(129), JOYSTICK_CUBIC(130), JOYSTICK_CUBIC(131), JOYSTICK_CUBIC(132), JOYSTICK_CUBIC(133), JOYSTICK_CUBIC(134), JOYSTICK_CUBIC(135),
+  JOYSTICK_CUBIC(136), JOYSTICK_CUBIC(137), JOYSTICK_CUBIC(138), JOYSTICK_CUBIC(139), JOYSTICK_CUBIC(140), JOYSTICK_CUBIC(141), JOYSTICK_CUBIC(142), JOYSTICK_CUBIC(143),
+  JOYSTICK_CUBIC(144), JOYSTICK_CUBIC(145), JOYSTICK_CUBIC(146), JOYSTICK_CUBIC(147), JOYSTICK_CUBIC(148), JOYSTICK_CUBIC(149), JOYSTICK_CUBIC(150), JOYSTICK_CUBIC(151),
+  JOYSTICK_CUBIC(152), JOYSTICK_CUBIC(153), JOYSTICK_CUBIC(154), JOYSTICK_CUBIC(155), JOYSTICK_CUBIC(156), JOYSTICK_CUBIC(157), JOYSTICK_CUBIC(158), JOYSTICK_CUBIC(159),
+  JOYSTICK_CUBIC(160), JOYSTICK_CUBIC(161), JOYSTICK_CUBIC(162), JOYSTICK_CUBIC(163), JOYSTICK_CUBIC(164), JOYSTICK_CUBIC(165), JOYSTICK_CUBIC(166), JOYSTICK_CUBIC(167),
+  JOYSTICK_CUBIC(168), JOYSTICK_CUBIC(169), JOYSTICK_CUBIC(170), JOYSTICK_CUBIC(171), JOYSTICK_CUBIC(172), JOYSTICK_CUBIC(173), JOYSTICK_CUBIC(174), JOYSTICK_CUBIC(175),
+  JOYSTICK_CUBIC(176), JOYSTICK_CUBIC(177), JOYSTICK_CUBIC(178), JOYSTICK_CUBIC(179), JOYSTICK_CUBIC(180), JOYSTICK_CUBIC(181), JOYSTICK_CUBIC(182), JOYSTICK_CUBIC(183),
+  JOYSTICK_CUBIC(184), JOYSTICK_CUBIC(185), JOYSTICK_CUBIC(186), JOYSTICK_CUBIC(187), JOYSTICK_CUBIC(188), JOYSTICK_CUBIC(189), JOYSTICK_CUBIC(190), JOYSTICK_CUBIC(191),
+  JOYSTICK_CUBIC(192), JOYSTICK_CUBIC(193), JOYSTICK_CUBIC(194), JOYSTICK_CUBIC(195), JOYSTICK_CUBIC(196), JOYSTICK_CUBIC(197), JOYSTICK_CUBIC(198), JOYSTICK_CUBIC(199),
+  JOYSTICK_CUBIC(200), JOYSTICK_CUBIC(201), JOYSTICK_CUBIC(202), JOYSTICK_CUBIC(203), JOYSTICK_CUBIC(204), JOYSTICK_CUBIC(205), JOYSTICK_CUBIC(206), JOYSTICK_CUBIC(207),
+  JOYSTICK_CUBIC(208), JOYSTICK_CUBIC(209), JOYSTICK_CUBIC(210), JOYSTICK_CUBIC(211), JOYSTICK_CUBIC(212), JOYSTICK_CUBIC(213), JOYSTICK_CUBIC(214), JOYSTICK_CUBIC(215),
+  JOYSTICK_CUBIC(216), JOYSTICK_CUBIC(217), JOYSTICK_CUBIC(218), JOYSTICK_CUBIC(219), JOYSTICK_CUBIC(220), JOYSTICK_CUBIC(221), JOYSTICK_CUBIC(222), JOYSTICK_CUBIC(223),
+  JOYSTICK_CUBIC(224), JOYSTICK_CUBIC(225), JOYSTICK_CUBIC(226), JOYSTICK_CUBIC(227), JOYSTICK_CUBIC(228), JOYSTICK_CUBIC(229), JOYSTICK_CUBIC(230), JOYSTICK_CUBIC(231),
+  JOYSTICK_CUBIC(232), JOYSTICK_CUBIC(233), JOYSTICK_CUBIC(234), JOYSTICK_CUBIC(235), JOYSTICK_CUBIC(236), JOYSTICK_CUBIC(237), JOYSTICK_CUBIC(238), JOYSTICK_CUBIC(239),
+  JOYSTICK_CUBIC(240), JOYSTICK_CUBIC(241), JOYSTICK_CUBIC(242), JOYSTICK_CUBIC(243), JOYSTICK_CUBIC(244), JOYSTICK_CUBIC(245), JOYSTICK_CUBIC(246), JOYSTICK_CUBIC(247),
+  JOYSTICK_CUBIC(248), JOYSTICK_CUBIC(249), JOYSTICK_CUBIC(250), JOYSTICK_CUBIC(251), JOYSTICK_CUBIC(252), JOYSTICK_CUBIC(253), JOYSTICK_CUBIC(254), JOYSTICK_CUBIC(255)
+};
+
+
+/*******************************************************************************
+* FUNCTION NAME: Joystick_Cubic
+* PURPOSE:       Computes the cubic joystick response curve in fixed point.
+* CALLED FROM:   Default_Routine, this file
+* ARGUMENTS:     
+*     Argument             Type    IO   Description
+*     --------             ----    --   -----------
+*     input         unsigned char  I    joystick axis value
+* RETURNS:       unsigned int (0 to 257)
+*
+* Gives the same result as Joystick_Cubic_Table[input] and as the old
+* floating point code, which truncated (x - 127)^3 / 16129 + 127. That sum
+* is never negative, so truncating is the same as rounding down, and the
+* cube fits in a long exactly.
+*******************************************************************************/
+unsigned int Joystick_Cubic (unsigned char input)
+{
+  long offset;
+
+  offset = (long)input - 127;
+  return (unsigned int) ((offset * offset * offset + 127L * 16129L) / 16129L);
+}
+
+
 
 
 /*******************************************************************************
@@ -156,7 +227,7 @@ void User_Initialization (void)
   pwm12 = 254 - (32 + 120);
 
 
-/* FIFTH: Set your PWM output types for PWM OUTPUTS 13-16.
+/* FIFTH: Set your PWM output types for PWM OUTPUTS 13-16. */
   /*   Choose from these parameters for PWM 13-16 respectively:               */
   /*     IFI_PWM  - Standard IFI PWM output generated with Generate_Pwms(...) */
   /*     USER_CCP - User can use PWM pin as digital I/O or CCP pin.           */
@@ -179,6 +250,14 @@ void User_Initialization (void)
   Init_Serial_Port_One();
   Init_Serial_Port_Two();
 
+  Profile_Initialize_Timer();
+
+  Initialize_Drive_Curves();
+
+  Initialize_Hood();
+
+  Initialize_Yaw();
+
 
 			
 #ifdef TERMINAL_SERIAL_PORT_1    
@@ -210,35 +289,21 @@ void User_Initialization (void)
 *******************************************************************************/
 void Process_Data_From_Master_uP(void)
 {
-	static unsigned char count = 0;
 	static unsigned char camera_menu_active = 0;
 	static unsigned char tracking_menu_active = 0;
 	unsigned char terminal_char;
-	unsigned char returned_value;
+	unsigned char terminal_tx_policy;
 
 	static int barf = 0;
-	static int runBarf = 0;
-	static int barfForward = 1;
-	static int barfCount = 1;
-
-	static int firstLock = 0;
-	static int raise = 0;
-	static int lower = 0;
 
 	static int shooterPosition = 0;  // 0 is down, 1 is up
 	static int shooterGoingDown = 0;
 	static int shooterGoingUp = 0;
-	static int shooterGoingUpCount = 0;
-	static int shooterGoingDownCount = 0;
 	
 	static int readyToShoot = 0;
-	static int letMyAimBeTrue = 0;
-	static int inRange = 0;
 	
 	int shooterOverride = 0;
-	int beltStop = 0;
 	int emergencyStop = 0;
-	int turretOverride = 0;
 	int turretLeft = 0;
 	int turretRight = 0;
 	
@@ -249,18 +314,14 @@ void Process_Data_From_Master_uP(void)
 	int shooterButton = 0;
 	static int buttonCount = 0;
 	static int shooterRunning = 0;
-	static int shooterLoop = 0;
 	
 	
 
-	// Start at 10
-	const int hoodAngle[] = {96, 96, 96, 96, 32, 30, 28, 27, 26, 26,
-							 26, 26, 26, 26, 26, 26, 26, 26, 32, 32,
-							 27, 28, 28, 28, 29, 30, 30, 31, 31, 33, };
 
 
-	
+	PROFILE_START(PROFILE_GETDATA);
 	Getdata(&rxdata);
+	PROFILE_STOP(PROFILE_GETDATA);
 	
 
 	
@@ -273,7 +334,6 @@ void Process_Data_From_Master_uP(void)
 	if ((shooterButton == 1) & (shooterRunning == 0))
 	{
 		shooterRunning = 1;
-		shooterLoop = 0;
 		buttonCount = 0;
 	}
 	if (shooterRunning == 1)
@@ -342,21 +402,31 @@ void Process_Data_From_Master_uP(void)
 	
 	// send diagnostic information to the terminal, but don't 
 	// overwrite the camera or tracking menu if it's active
+	PROFILE_START(PROFILE_TERMINAL);
 	if(camera_menu_active == 0 && tracking_menu_active == 0)
 	{
+		// the diagnostic information is only a convenience, so throw
+		// away whatever doesn't fit in the transmit queue rather than
+		// wait for it and risk missing the Putdata() deadline
+		terminal_tx_policy = TERMINAL_TX_FULL_POLICY;
+		TERMINAL_TX_FULL_POLICY = TX_DROP_NEWEST;
 		Tracking_Info_Terminal();
+		TERMINAL_TX_FULL_POLICY = terminal_tx_policy;
 	}
+	PROFILE_STOP(PROFILE_TERMINAL);
 
 	// This function is responsable for camera initialization 
 	// and camera serial data interpretation. Once the camera
 	// is initialized and starts sending tracking data, this 
 	// function will continuously update the global T_Packet_Data 
 	// structure with the received tracking information.
+	PROFILE_START(PROFILE_CAMERA_HANDLER);
 	Camera_Handler();
+	PROFILE_STOP(PROFILE_CAMERA_HANDLER);
 
 	
-	// This function reads data placed in the T_Packet_Data
-	// structure by the Camera_Handler() function and if new
+	// This function reads the latest T packet published by
+	// the camera code and if new
 	// tracking data is available, attempts to keep the center
 	// of the tracked object in the center of the camera's
 	// image using two servos that drive a pan/tilt platform.
@@ -364,17 +434,17 @@ void Process_Data_From_Master_uP(void)
 	// of view, this function will execute a search algorithm 
 	// in an attempt to find the object.
 
+	PROFILE_START(PROFILE_SERVO_TRACK);
 	if(tracking_menu_active == 0)
 	{
-		letMyAimBeTrue = Servo_Track(pwm01, pwm03);
+		Servo_Track(pwm01, pwm03);
 	}
+	PROFILE_STOP(PROFILE_SERVO_TRACK);
 	
-	if (letMyAimBeTrue == 300)
-		pwm09 = 127;
-
 
 	// this logic guarantees that only one of the menus can be
 	// active at any giiven time
+	PROFILE_START(PROFILE_TERMINAL);
 	if(camera_menu_active == 1)
 	{
 		// This function manages the camera menu functionality,
@@ -403,14 +473,23 @@ void Process_Data_From_Master_uP(void)
 		{
 			tracking_menu_active = 1;
 		}
+		#ifdef ENABLE_PROFILING
+		else if(terminal_char == PROFILE_DUMP_KEY)
+		{
+			Profile_Dump();
+		}
+		#endif
 	}
+	PROFILE_STOP(PROFILE_TERMINAL);
 
 	// This funtion is used by the functions Camera_Menu() and
 	// Tracking_Menu() to manage the writing of initialization
 	// parameters to your robot controller's non-volatile
 	// Electrically Erasable Programmable Read-Only Memory
 	// (EEPROM)
+	PROFILE_START(PROFILE_EEPROM);
 	EEPROM_Write_Handler();
+	PROFILE_STOP(PROFILE_EEPROM);
 /*	
 	// Check if it is first lock
 		if ((letMyAimBeTrue == 1) && (firstLock == 0))
@@ -422,14 +501,10 @@ void Process_Data_From_Master_uP(void)
 			shooterMoving = 1;			
 		}
 */		
-	// If Camera is Aimed and shooter is not moving, Shoot
-	if ((shooterGoingUp != 1) && (shooterGoingDown != 1) && (shooterPosition == 0) && (shooterOverride != 1) && (letMyAimBeTrue == 1))
-		readyToShoot = 1;
-	
-	if ((letMyAimBeTrue > 13) && (letMyAimBeTrue < 40))
-		inRange = 1;
+	// If Camera is Aimed and in range and shooter is not moving, Shoot
+	readyToShoot = (shooterGoingUp != 1) && (shooterGoingDown != 1) && (shooterPosition == 0) && (shooterOverride != 1) && (Tracking_Shot_Ready() == 1);
 		
-	if ((letMyAimBeTrue != 1) && (readyToShoot == 1) && (inRange == 1))
+	if (readyToShoot == 1)
 	{
 		/* AUTOMATIC SHOOTING
 		// Start raising
@@ -448,7 +523,7 @@ void Process_Data_From_Master_uP(void)
 		
 					
 	}
-	else if (letMyAimBeTrue == 1)
+	else if (Tracking_State.State == TRACKING_AIMED)
 	{
 		Pwm1_green = 1;
 		Pwm1_red = 0;
@@ -541,41 +616,9 @@ void Process_Data_From_Master_uP(void)
 	//	UPDATE HOOD ANGLE
 	//------------------------------------------------
 	
-	if (pwm10 < 10)
-	{
-		pwm11 = 30;
-		pwm12 = 254 - pwm11;
-	}
-	else if (pwm10 < 15)
-	{
-		pwm11 = 39;
-		pwm12 = 254 - pwm11;
-	}
-	else if (pwm10 < 23)
-	{
-		pwm11 = 32;
-		pwm12 = 254 - pwm11;
-	}
-	else if (pwm10 < 55)
-	{
-		pwm11 = 26;
-		pwm12 = 254 - pwm11;
-	}	
-	else if (pwm10 < 62)
-	{
-		pwm11 = 27;
-		pwm12 = 254 - pwm11;
-	}	
-	else if (pwm10 < 65)
-	{
-		pwm11 = 30;
-		pwm12 = 254 - pwm11;
-	}	
-	else 
-	{
-		pwm11 = 26;
-		pwm12 = 254 - pwm11;
-	}	
+	PROFILE_START(PROFILE_HOOD);
+	Hood_Update(Tracking_State.Range);
+	PROFILE_STOP(PROFILE_HOOD);
 	
 
 	
@@ -624,8 +667,15 @@ void Process_Data_From_Master_uP(void)
 
 	
 
+	// spread large steps in the turret, tilt and drive
+	// commands over several frames
+	Slew_Outputs();
+
+	PROFILE_START(PROFILE_PUTDATA);
 	Putdata(&txdata);
+	PROFILE_STOP(PROFILE_PUTDATA);
 
+	PROFILE_END_OF_LOOP();
 
 
 //  ***  IFI Code Starts Here***
@@ -667,8 +717,8 @@ void Process_Data_From_Master_uP(void)
 *******************************************************************************/
 void Default_Routine(void)
 {
- 	double outputX;
-	double outputY;
+ 	int outputX;
+	int outputY;
  // Driving lookup tables
 
 	   
@@ -731,11 +781,35 @@ void Default_Routine(void)
 */
 	p1_x = 127 - (p1_x - 127);
 	p1_y = 127 - (p1_y - 127);
-	outputX = (((((double)p1_x-127)*((double)p1_x - 127)*((double)p1_x - 127)) / 16129) + 127);
-	outputY = (((((double)p1_y-127)*((double)p1_y - 127)*((double)p1_y - 127)) / 16129) + 127);
+	/* the driver's response curves (see drive_curves.c); the cubic is */
+	/* handled here, see JOYSTICK_X_CURVE in user_routines.h           */
+	if (Drive_Curve_Type(DRIVE_CURVE_X) == DRIVE_CURVE_CUBIC)
+	{
+#if JOYSTICK_X_CURVE == JOYSTICK_CURVE_TABLE
+		outputX = Joystick_Cubic_Table[p1_x];
+#else
+		outputX = Joystick_Cubic(p1_x);
+#endif
+	}
+	else
+	{
+		outputX = Drive_Curve_Lookup(DRIVE_CURVE_X, p1_x);
+	}
+	if (Drive_Curve_Type(DRIVE_CURVE_Y) == DRIVE_CURVE_CUBIC)
+	{
+#if JOYSTICK_Y_CURVE == JOYSTICK_CURVE_TABLE
+		outputY = Joystick_Cubic_Table[p1_y];
+#else
+		outputY = Joystick_Cubic(p1_y);
+#endif
+	}
+	else
+	{
+		outputY = Drive_Curve_Lookup(DRIVE_CURVE_Y, p1_y);
+	}
 
-	pwm01 = pwm02 = Limit_Mix(2000 + (int)outputY + (int)outputX - 127);  // forward 0, backward 255, left 0 right 255 to turn left
-    pwm03 = pwm04 = Limit_Mix(2000 - (int)outputY + (int)outputX + 127); 
+	pwm01 = pwm02 = Limit_Mix(2000 + outputY + outputX - 127);  // forward 0, backward 255, left 0 right 255 to turn left
+    pwm03 = pwm04 = Limit_Mix(2000 - outputY + outputX + 127); 
 /*    
     printf("Left Drive: %u\r\n", pwm01);
     printf("Right Drive: %u\r\n", pwm03);
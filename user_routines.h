@@ -40,6 +40,16 @@
 #define OPEN        1     /* Limit switch is open (input is floating high). */
 #define CLOSED      0     /* Limit switch is closed (input connected to ground). */
 
+/* How Default_Routine() computes the cubic response curve for each axis     */
+/* when the driver has DRIVE_CURVE_CUBIC selected (see drive_curves.h).      */
+/* JOYSTICK_CURVE_TABLE reads the cubic from a 256 entry table in ROM and     */
+/* JOYSTICK_CURVE_CUBIC computes it with integer math. Both give exactly the  */
+/* same drive outputs as the floating point code they replace.                */
+#define JOYSTICK_CURVE_TABLE  0
+#define JOYSTICK_CURVE_CUBIC  1
+#define JOYSTICK_X_CURVE      JOYSTICK_CURVE_TABLE
+#define JOYSTICK_Y_CURVE      JOYSTICK_CURVE_TABLE
+
 
 /*******************************************************************************
                             TYPEDEF DECLARATIONS
@@ -68,6 +78,9 @@ void User_Initialization(void);
 void Process_Data_From_Master_uP(void);
 void Default_Routine(void);
 void shootTheJ(void);
+unsigned int Joystick_Cubic(unsigned char);
+
+extern rom const unsigned int Joystick_Cubic_Table[256];
 
 /* These routines reside in user_routines_fast.c */
 void InterruptHandlerLow (void);  /* DO NOT CHANGE! */
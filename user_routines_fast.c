@@ -17,7 +17,12 @@
 #include "ifi_default.h"
 #include "ifi_utilities.h"
 #include "user_routines.h"
+#include "sim.h"
 #include "serial_ports.h"
+#include "camera.h"
+#include "tracking.h"
+#include "slew.h"
+#include "hood.h"
 // #include "user_Serialdrv.h"
 
 
@@ -35,9 +40,11 @@
 #pragma code InterruptVectorLow = LOW_INT_VECTOR
 void InterruptVectorLow (void)
 {
+#ifndef _SIMULATOR
   _asm
     goto InterruptHandlerLow  /*jump to interrupt routine*/
   _endasm
+#endif
 }
 
 
@@ -59,30 +66,35 @@ void InterruptVectorLow (void)
 
 void InterruptHandlerLow ()     
 {
-	if (PIR1bits.RC1IF && PIE1bits.RC1IE) // rx1 interrupt?
-	{
-		#ifdef ENABLE_SERIAL_PORT_ONE_RX
-		Rx_1_Int_Handler(); // call the rx1 interrupt handler (in serial_ports.c)
-		#endif
-	}                              
-	else if (PIR3bits.RC2IF && PIE3bits.RC2IE) // rx2 interrupt?
+	// Every source is checked on each pass, rather than stopping at the
+	// first one found, so that a single trip through the interrupt entry
+	// and exit code services everything that's pending. The receivers
+	// come first because they lose data if they aren't serviced in time.
+	// Serial port two's receiver is serviced before serial port one's.
+	if (PIR3bits.RC2IF && PIE3bits.RC2IE) // rx2 interrupt?
 	{
 		#ifdef ENABLE_SERIAL_PORT_TWO_RX
 		Rx_2_Int_Handler(); // call the rx2 interrupt handler (in serial_ports.c)
 		#endif
 	} 
-	else if (PIR1bits.TX1IF && PIE1bits.TX1IE) // tx1 interrupt?
+	if (PIR1bits.RC1IF && PIE1bits.RC1IE) // rx1 interrupt?
 	{
-		#ifdef ENABLE_SERIAL_PORT_ONE_TX
-		Tx_1_Int_Handler(); // call the tx1 interrupt handler (in serial_ports.c)
+		#ifdef ENABLE_SERIAL_PORT_ONE_RX
+		Rx_1_Int_Handler(); // call the rx1 interrupt handler (in serial_ports.c)
 		#endif
 	}                              
-	else if (PIR3bits.TX2IF && PIE3bits.TX2IE) // tx2 interrupt?
+	if (PIR3bits.TX2IF && PIE3bits.TX2IE) // tx2 interrupt?
 	{
 		#ifdef ENABLE_SERIAL_PORT_TWO_TX
 		Tx_2_Int_Handler(); // call the tx2 interrupt handler (in serial_ports.c)
 		#endif
 	}
+	if (PIR1bits.TX1IF && PIE1bits.TX1IE) // tx1 interrupt?
+	{
+		#ifdef ENABLE_SERIAL_PORT_ONE_TX
+		Tx_1_Int_Handler(); // call the tx1 interrupt handler (in serial_ports.c)
+		#endif
+	}                              
 
 
 
@@ -121,16 +133,6 @@ void InterruptHandlerLow ()
 *******************************************************************************/
 void User_Autonomous_Code(void)
 {
-      static int shooterPosition = 0;  // 0 is down, 1 is up
-	static int shooterGoingDown = 0;
-	static int shooterGoingUp = 0;
-	static int shooterGoingUpCount = 0;
-	static int shooterGoingDownCount = 0;
-	
-	static int readyToShoot = 0;
-	static int letMyAimBeTrue = 0;
-	static int inRange = 0;
-	
 	int shooterOverride = 0;
 	
 	static int loopCount = 0;
@@ -139,7 +141,6 @@ void User_Autonomous_Code(void)
 	int shooterButton = 0;
 	static int buttonCount = 0;
 	static int shooterRunning = 0;
-	static int shooterLoop = 0;
 	static int firstPush = 0;
 	static int firstLetGo = 0;
 	
@@ -147,8 +148,6 @@ void User_Autonomous_Code(void)
 	int firstDrive = 500;
 	int firstTurn = 620;
 	int secondDrive = 1300;
-	int secondTurn = 0;
-	int thirdDrive = 0;
   
   /* Initialize all PWMs and Relays when entering Autonomous mode, or else it
      will be stuck with the last values mapped from the joysticks.  Remember, 
@@ -178,7 +177,6 @@ void User_Autonomous_Code(void)
 	if ((shooterButton == 1) & (shooterRunning == 0))
 	{
 		shooterRunning = 1;
-		shooterLoop = 0;
 		buttonCount = 0;
 	}
 	if (shooterRunning == 1)
@@ -247,18 +245,9 @@ void User_Autonomous_Code(void)
 
         Camera_Handler();
         
-        letMyAimBeTrue = Servo_Track(pwm01, pwm03);
+        Servo_Track(pwm01, pwm03);
         
-        if ((shooterGoingUp != 1) && (shooterGoingDown != 1) && (shooterPosition == 0) && (shooterOverride != 1) && (letMyAimBeTrue == 1))
-			readyToShoot = 1;
-	
-		if ((letMyAimBeTrue > 13) && (letMyAimBeTrue < 40))
-			inRange = 1;
-		
-		if ((letMyAimBeTrue != 1) && (readyToShoot == 1) )
-		{
-			readyToShoot = 0;			
-		}
+        Slew_Camera_Outputs();
 /*		
 		// Motor Control
 		// Go backward
@@ -377,45 +366,12 @@ void User_Autonomous_Code(void)
 		// HOOD ANGLE
 		//=========================
 		
-	if (pwm10 < 10)
-	{
-		pwm11 = 30;
-		pwm12 = 254 - pwm11;
-	}
-	else if (pwm10 < 15)
-	{
-		pwm11 = 39;
-		pwm12 = 254 - pwm11;
-	}
-	else if (pwm10 < 23)
-	{
-		pwm11 = 32;
-		pwm12 = 254 - pwm11;
-	}
-	else if (pwm10 < 55)
-	{
-		pwm11 = 26;
-		pwm12 = 254 - pwm11;
-	}	
-	else if (pwm10 < 62)
-	{
-		pwm11 = 27;
-		pwm12 = 254 - pwm11;
-	}	
-	else if (pwm10 < 65)
-	{
-		pwm11 = 30;
-		pwm12 = 254 - pwm11;
-	}	
-	else 
-	{
-		pwm11 = 26;
-		pwm12 = 254 - pwm11;
-	}	
+		Hood_Update(Tracking_State.Range);
 	
         Putdata(&txdata);   /* DO NOT DELETE, or you will get no PWM outputs! */
         autoCount++;
     
+        Process_Data_From_Local_IO();
   }
 }
 
@@ -432,6 +388,11 @@ void User_Autonomous_Code(void)
 void Process_Data_From_Local_IO(void)
 {
   /* Add code here that you want to be executed every program loop. */
+
+  /* Parse camera data as it arrives, rather than letting it pile up
+     in the serial port's queue until the next slow loop. */
+  Camera_Drain();
+
 /*	if (p1_sw_top == 1)
 	{
 		pwm05 = pwm06 = 0; // Rotate Left (clockwise)
@@ -0,0 +1,168 @@
+/*******************************************************************************
+*
+*	TITLE:		yaw.c
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	This file estimates how fast the robot is turning, so
+*				that the turret can be turned the other way before the
+*				camera sees the target move.
+*
+*				The estimate comes from a model of the drive: the turn
+*				command (the sum of the right and left drive commands,
+*				less twice neutral) times a calibrated scale, passed
+*				through a first order lag for the robot's inertia.
+*
+*				If ENABLE_YAW_GYRO is #define'd in yaw.h, a yaw rate
+*				gyro is also read through Get_Analog_Value() and blended
+*				with the model. The gyro bias is measured at power up
+*				and follows drift while the robot isn't being told to
+*				turn.
+*
+*				All of the math is integer.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#include "ifi_default.h"
+#include "ifi_aliases.h"
+#include "ifi_utilities.h"
+#include "yaw.h"
+
+// drive model yaw rate, in sixteenths of a degree per second
+static int yaw_model_rate = 0;
+
+// blended yaw rate, in sixteenths of a degree per second
+static int yaw_rate = 0;
+
+#ifdef ENABLE_YAW_GYRO
+// gyro output at zero yaw rate, in sixteenths of an ADC count
+static int yaw_gyro_bias = 512 * 16;
+#endif
+
+/*******************************************************************************
+*
+*	FUNCTION:		Initialize_Yaw()
+*
+*	PURPOSE:		Clears the yaw rate estimate and, if a gyro is used,
+*					measures its bias.
+*
+*	CALLED FROM:	user_routines.c/User_Initialization()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		The robot must be still when this is called.
+*
+*******************************************************************************/
+void Initialize_Yaw(void)
+{
+#ifdef ENABLE_YAW_GYRO
+	unsigned char i;
+	unsigned int sum;
+
+	// Add up YAW_GYRO_BIAS_SAMPLES readings. With sixteen samples,
+	// the sum is the bias in sixteenths of a count.
+	sum = 0;
+	for(i = 0; i < YAW_GYRO_BIAS_SAMPLES; i++)
+	{
+		sum += Get_Analog_Value(YAW_GYRO_CHANNEL);
+	}
+
+	yaw_gyro_bias = (int)(sum * (16 / YAW_GYRO_BIAS_SAMPLES));
+#endif
+
+	yaw_model_rate = 0;
+	yaw_rate = 0;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Yaw_Update()
+*
+*	PURPOSE:		Updates the yaw rate estimate.
+*
+*	CALLED FROM:	tracking.c/Servo_Track()
+*
+*	PARAMETERS:		Right and left drive motor commands (pwm01 and pwm03).
+*
+*	RETURNS:		Nothing.
+*
+*	COMMENTS:		Call once per slow loop.
+*
+*******************************************************************************/
+void Yaw_Update(int driveR, int driveL)
+{
+	int turn;
+#ifdef ENABLE_YAW_GYRO
+	int gyro_offset;
+	int gyro_rate;
+#endif
+
+	// the drive turn command, less the deadband
+	turn = driveR + driveL - 254;
+
+	if(turn > YAW_DRIVE_DEADBAND)
+	{
+		turn -= YAW_DRIVE_DEADBAND;
+	}
+	else if(turn < -YAW_DRIVE_DEADBAND)
+	{
+		turn += YAW_DRIVE_DEADBAND;
+	}
+	else
+	{
+		turn = 0;
+	}
+
+	// move the model rate part of the way toward the commanded rate
+	yaw_model_rate += (turn * YAW_DRIVE_SCALE - yaw_model_rate) / YAW_DRIVE_LAG;
+
+#ifdef ENABLE_YAW_GYRO
+	// gyro output relative to its bias, in sixteenths of a count
+	gyro_offset = (int)(Get_Analog_Value(YAW_GYRO_CHANNEL) << 4) - yaw_gyro_bias;
+
+	// follow the bias while we aren't being told to turn
+	if(turn == 0)
+	{
+		yaw_gyro_bias += gyro_offset / YAW_GYRO_BIAS_FILTER;
+	}
+
+	gyro_rate = (int)((long)YAW_GYRO_SIGN * (long)gyro_offset * (long)YAW_GYRO_SCALE / 16L);
+
+	yaw_rate = (int)(((long)yaw_model_rate * (16 - YAW_GYRO_WEIGHT) +
+		(long)gyro_rate * YAW_GYRO_WEIGHT) / 16L);
+#else
+	yaw_rate = yaw_model_rate;
+#endif
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Get_Yaw_Rate()
+*
+*	PURPOSE:		Returns the estimated yaw rate.
+*
+*	CALLED FROM:	tracking.c/Servo_Track()
+*
+*	PARAMETERS:		None.
+*
+*	RETURNS:		Yaw rate in degrees per second, positive for a counter-
+*					clockwise turn.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+int Get_Yaw_Rate(void)
+{
+	return(yaw_rate / 16);
+}
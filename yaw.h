@@ -0,0 +1,73 @@
+/*******************************************************************************
+*
+*	TITLE:		yaw.h
+*
+*	VERSION:	0.1 (Beta)
+*
+*	DATE:		17-Oct-2026
+*
+*	COMMENTS:	Robot yaw rate estimation. See yaw.c for details.
+*
+********************************************************************************
+*
+*	CHANGE LOG:
+*
+*	DATE         REV  DESCRIPTION
+*	-----------  ---  ----------------------------------------------------------
+*	17-Oct-2026  0.1  Original code.
+*
+*******************************************************************************/
+#ifndef _YAW_H
+#define _YAW_H
+
+// Remove the comment slashes from the next line if a yaw rate
+// gyro is connected to YAW_GYRO_CHANNEL
+// #define ENABLE_YAW_GYRO
+
+// Yaw rates are kept in sixteenths of a degree per second internally.
+// Positive yaw is counter-clockwise, seen from above.
+
+// Yaw rate, in sixteenths of a degree per second, for each count of
+// the drive turn command (pwm01 + pwm03 - 254, positive for a
+// counter-clockwise turn). Calibrate by spinning the robot in place
+// at a known turn command and timing a full turn.
+#define YAW_DRIVE_SCALE 11
+
+// Turn commands smaller than this don't overcome the speed controller
+// deadband and friction, and are treated as zero.
+#define YAW_DRIVE_DEADBAND 6
+
+// The robot doesn't reach a new turn rate right away. The drive model
+// closes 1/YAW_DRIVE_LAG of the gap to the commanded rate each slow
+// loop. Four slow loops is about a tenth of a second.
+#define YAW_DRIVE_LAG 4
+
+// analog input the gyro is connected to
+#define YAW_GYRO_CHANNEL rc_ana_in01
+
+// Gyro scale, in sixteenths of a degree per second per ADC count.
+// The 10-bit ADC reads 5V/1024 = 4.88mV per count, which for a
+// 12.5mV/deg/s gyro (ADXRS150) is 0.39 deg/s, or 6.25 sixteenths.
+// Change the sign if the gyro is mounted upside down.
+#define YAW_GYRO_SCALE 6
+#define YAW_GYRO_SIGN +1
+
+// number of samples averaged to find the gyro bias at power up
+#define YAW_GYRO_BIAS_SAMPLES 16
+
+// While the robot isn't being told to turn, the gyro bias follows
+// the gyro output, closing 1/YAW_GYRO_BIAS_FILTER of the gap each
+// slow loop, to follow drift.
+#define YAW_GYRO_BIAS_FILTER 64
+
+// Share of the gyro rate, in sixteenths, in the blended yaw rate. The
+// rest comes from the drive model, which leads the gyro because the
+// command comes before the motion.
+#define YAW_GYRO_WEIGHT 12
+
+// function prototypes
+void Initialize_Yaw(void);
+void Yaw_Update(int, int);
+int Get_Yaw_Rate(void);
+
+#endif